@@ -0,0 +1,7 @@
+#pragma once
+#include <cstdint>
+
+// Number of global operator new calls since start. alloccounter.cpp replaces
+// the global allocation functions of the executable; counting is one relaxed
+// atomic increment per allocation.
+uint64_t allocationCount();
@@ -0,0 +1,167 @@
+#include "background.h"
+#include "settings.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QVector2D>
+#include <QVector4D>
+
+static const char* const VERTEX_SHADER = R"(
+varying vec2 screen;
+
+void main() {
+    screen = gl_Vertex.xy;
+    gl_Position = vec4(gl_Vertex.xy, 0.0, 1.0);
+}
+)";
+
+// Each star layer is a grid of cells holding at most one star, placed and
+// sized by a hash of the cell. Stars stay 0.2 cells away from the cell edges,
+// so a pixel only ever has to test its own cell.
+static const char* const FRAGMENT_SHADER = R"(
+uniform sampler2D nebula;
+uniform vec2 nebulaOffset;
+uniform float aspect;
+uniform vec2 layerOffset[LAYERS];
+uniform vec4 layerShape[LAYERS];    // cells, density, radius, unused
+uniform vec4 layerColor[LAYERS];    // rgb, opacity
+varying vec2 screen;
+
+float hash(vec2 p) {
+    vec3 p3 = fract(vec3(p.xyx) * 0.1031);
+    p3 += dot(p3, p3.yzx + 33.33);
+    return fract((p3.x + p3.y) * p3.z);
+}
+
+void main() {
+    vec3 color = texture2D(nebula, nebulaOffset + screen * 0.5).rgb;
+    for (int i = 0; i < LAYERS; ++i) {
+        vec2 p = (screen - layerOffset[i]) * vec2(aspect, 1.0) * (layerShape[i].x * 0.5);
+        vec2 cell = floor(p);
+        float present = step(1.0 - layerShape[i].y, hash(cell));
+        vec2 centre = 0.2 + 0.6 * vec2(hash(cell + 17.0), hash(cell + 59.0));
+        float radius = layerShape[i].z * (0.4 + 0.6 * hash(cell + 113.0));
+        float coverage = present * (1.0 - smoothstep(0.0, radius, length(p - cell - centre)));
+        color += layerColor[i].rgb * coverage * (1.0 - layerColor[i].a);
+        color = mix(color, layerColor[i].rgb, coverage * layerColor[i].a);
+    }
+    gl_FragColor = vec4(color, 1.0);
+}
+)";
+
+BackgroundRenderer::BackgroundRenderer() {
+    initializeOpenGLFunctions();
+
+    const QByteArray header = "#version 120\n#define LAYERS " + QByteArray::number(GameSettings::BACKGROUND_LAYER_COUNT) + "\n";
+    if (!program.addShaderFromSourceCode(QOpenGLShader::Vertex, header + VERTEX_SHADER) ||
+        !program.addShaderFromSourceCode(QOpenGLShader::Fragment, header + FRAGMENT_SHADER) ||
+        !program.link()) {
+        qDebug() << "Failed to build background shader:" << program.log();
+        return;
+    }
+
+    nebulaOffsetLocation = program.uniformLocation("nebulaOffset");
+    aspectLocation = program.uniformLocation("aspect");
+    layerOffsetLocation = program.uniformLocation("layerOffset");
+
+    // The layer table never changes, upload it once
+    QVector4D shapes[GameSettings::BACKGROUND_LAYER_COUNT];
+    QVector4D colors[GameSettings::BACKGROUND_LAYER_COUNT];
+    for (int i = 0; i < GameSettings::BACKGROUND_LAYER_COUNT; ++i) {
+        const auto& layer = GameSettings::BACKGROUND_LAYERS[i];
+        shapes[i] = QVector4D(layer.cells, layer.density, layer.radius, 0.0f);
+        colors[i] = QVector4D(layer.red, layer.green, layer.blue, layer.opacity);
+    }
+    program.bind();
+    program.setUniformValue("nebula", 0);
+    program.setUniformValueArray("layerShape", shapes, GameSettings::BACKGROUND_LAYER_COUNT);
+    program.setUniformValueArray("layerColor", colors, GameSettings::BACKGROUND_LAYER_COUNT);
+    program.release();
+
+    for (int i = 0; i < GameSettings::BACKGROUND_TIMER_QUERIES; ++i) {
+        auto query = std::make_unique<QOpenGLTimerQuery>();
+        if (!query->create()) {
+            qInfo() << "Background: no GPU timer queries";
+            timerQueries.clear();
+            break;
+        }
+        timerQueries.push_back(std::move(query));
+    }
+    queryPending.assign(timerQueries.size(), false);
+}
+
+void BackgroundRenderer::draw(QOpenGLTexture& nebula, float cameraX, float cameraY, float aspectRatio) {
+    if (!isValid()) {
+        return;
+    }
+
+    if (timerQueries.empty()) {
+        if (!finishTiming) {
+            drawPass(nebula, cameraX, cameraY, aspectRatio);
+            return;
+        }
+        glFinish();
+        QElapsedTimer timer;
+        timer.start();
+        drawPass(nebula, cameraX, cameraY, aspectRatio);
+        glFinish();
+        gpuTime = static_cast<uint64_t>(timer.nsecsElapsed());
+        hasGpuTime = true;
+        return;
+    }
+
+    // The oldest query in the ring was issued BACKGROUND_TIMER_QUERIES frames
+    // ago. If even that one isn't done, skip timing this frame rather than wait.
+    QOpenGLTimerQuery& query = *timerQueries[nextQuery];
+    if (queryPending[nextQuery]) {
+        if (!query.isResultAvailable()) {
+            drawPass(nebula, cameraX, cameraY, aspectRatio);
+            return;
+        }
+        gpuTime = query.waitForResult();
+        hasGpuTime = true;
+    }
+
+    query.begin();
+    drawPass(nebula, cameraX, cameraY, aspectRatio);
+    query.end();
+    queryPending[nextQuery] = true;
+    nextQuery = (nextQuery + 1) % timerQueries.size();
+}
+
+bool BackgroundRenderer::takeGpuTime(uint64_t& nanoseconds) {
+    if (!hasGpuTime) {
+        return false;
+    }
+    nanoseconds = gpuTime;
+    hasGpuTime = false;
+    return true;
+}
+
+void BackgroundRenderer::drawPass(QOpenGLTexture& nebula, float cameraX, float cameraY, float aspectRatio) {
+    // Nebula texture coordinates as the old camera-relative quad had them:
+    // moving with the camera, minus the SCROLL_FACTOR drift
+    QVector2D nebulaOffset(
+        cameraX * GameSettings::SCROLL_FACTOR_X - cameraX * 0.5f + GameSettings::BACKGROUND_SCALE_X * 0.5f,
+        cameraY * GameSettings::SCROLL_FACTOR_Y - cameraY * 0.5f + GameSettings::BACKGROUND_SCALE_Y * 0.5f);
+
+    QVector2D layerOffsets[GameSettings::BACKGROUND_LAYER_COUNT];
+    for (int i = 0; i < GameSettings::BACKGROUND_LAYER_COUNT; ++i) {
+        layerOffsets[i] = QVector2D(cameraX, cameraY) * GameSettings::BACKGROUND_LAYERS[i].scroll;
+    }
+
+    program.bind();
+    program.setUniformValue(nebulaOffsetLocation, nebulaOffset);
+    program.setUniformValue(aspectLocation, aspectRatio);
+    program.setUniformValueArray(layerOffsetLocation, layerOffsets, GameSettings::BACKGROUND_LAYER_COUNT);
+    nebula.bind(0);
+
+    glBegin(GL_QUADS);
+        glVertex2f(-1.0f, -1.0f);
+        glVertex2f(1.0f, -1.0f);
+        glVertex2f(1.0f, 1.0f);
+        glVertex2f(-1.0f, 1.0f);
+    glEnd();
+
+    nebula.release();
+    program.release();
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLTexture>
+#include <QOpenGLTimerQuery>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Draws the whole parallax background in one full-screen fragment shader
+// pass: the nebula texture plus the procedural star and debris layers of
+// GameSettings::BACKGROUND_LAYERS, each scrolling at its own rate. Adding a
+// layer costs shader work per pixel, not another full-screen fill.
+//
+// The pass is timed on the GPU with timer queries when the driver has them,
+// read back a few frames later so the renderer never waits for the GPU.
+class BackgroundRenderer : protected QOpenGLFunctions {
+public:
+    // Needs the GL context current; so does destroying the renderer
+    BackgroundRenderer();
+
+    bool isValid() const { return program.isLinked(); }
+
+    // Fills the viewport. Ignores the current matrices, the camera only
+    // drives the layer offsets.
+    void draw(QOpenGLTexture& nebula, float cameraX, float cameraY, float aspectRatio);
+
+    // Without timer queries the pass can still be timed by waiting for the
+    // GPU before and after it. Only worth it when frames wait anyway (soak).
+    void setFinishTiming(bool finish) { finishTiming = finish; }
+    bool hasTimerQueries() const { return !timerQueries.empty(); }
+
+    // GPU time of a finished pass, at most one per draw. False if none came in.
+    bool takeGpuTime(uint64_t& nanoseconds);
+
+private:
+    void drawPass(QOpenGLTexture& nebula, float cameraX, float cameraY, float aspectRatio);
+
+    QOpenGLShaderProgram program;
+    int nebulaOffsetLocation = -1;
+    int aspectLocation = -1;
+    int layerOffsetLocation = -1;
+
+    std::vector<std::unique_ptr<QOpenGLTimerQuery>> timerQueries;
+    std::vector<bool> queryPending;
+    size_t nextQuery = 0;
+    bool finishTiming = false;
+
+    uint64_t gpuTime = 0;
+    bool hasGpuTime = false;
+};
@@ -0,0 +1,92 @@
+#include "behaviour.h"
+#include <cmath>
+
+using std::ceil;
+using std::sqrt;
+
+BehaviourScheduler::BehaviourScheduler(World& world) : world(world) {
+}
+
+BehaviourScheduler::~BehaviourScheduler() {
+    // Frames go back to framePool, which is destroyed after this
+    timers.forEachPending([](Behaviour::Handle handle) { handle.destroy(); });
+}
+
+void BehaviourScheduler::resumeAfter(Behaviour::Handle handle, uint32_t ticks) {
+    timers.schedule(ticks, handle);
+}
+
+void BehaviourScheduler::finish(Behaviour::Handle handle) {
+    handle.destroy();
+    --activeCount;
+}
+
+void BehaviourScheduler::clear() {
+    timers.forEachPending([](Behaviour::Handle handle) { handle.destroy(); });
+    timers.clear();
+    activeCount = 0;
+}
+
+void BehaviourScheduler::tick() {
+    // Behaviours resumed here that wait 0 ticks run in the next tick(), as
+    // advance() has moved the clock on by then
+    timers.advance(running);
+
+    for (auto handle : running) {
+        EntityId entity = handle.promise().entity;
+        if (entity.index != UINT32_MAX && !world.isAlive(entity)) {
+            finish(handle); // Entity is gone, so is its script
+            continue;
+        }
+
+        handle.resume();
+        if (handle.done()) {
+            finish(handle);
+        }
+    }
+    running.clear();
+}
+
+bool Reach::await_suspend(Behaviour::Handle handle) {
+    BehaviourScheduler& scheduler = *handle.promise().scheduler;
+    world = &scheduler.getWorld();
+    entity = handle.promise().entity;
+    if (!world->isAlive(entity)) {
+        return false;
+    }
+
+    ArchetypeTable& table = world->table(world->archetypeOf(entity));
+    size_t row = world->rowOf(entity);
+    SimulationReal dx = targetX - table.positionX[row];
+    SimulationReal dy = targetY - table.positionY[row];
+    SimulationReal distance = sqrt(dx * dx + dy * dy);
+    if (speed <= SimulationReal()) {
+        world = nullptr; // Can't move, continue right away without snapping
+        return false;
+    }
+    if (distance <= SimulationReal()) {
+        return false; // Already there, continue right away
+    }
+
+    table.velocityX[row] = dx / distance * speed;
+    table.velocityY[row] = dy / distance * speed;
+    // Moves this tick and every tick until the arrival one, whole ticks so the
+    // conversion through float is exact for Fixed too
+    uint32_t ticks = static_cast<uint32_t>(static_cast<float>(ceil(distance / speed)));
+    scheduler.resumeAfter(handle, std::max(ticks, 1u) - 1);
+    return true;
+}
+
+void Reach::await_resume() {
+    // The last step may have gone past the target by less than one step, land
+    // exactly on it
+    if (!world || !world->isAlive(entity)) {
+        return;
+    }
+    ArchetypeTable& table = world->table(world->archetypeOf(entity));
+    size_t row = world->rowOf(entity);
+    table.positionX[row] = targetX;
+    table.positionY[row] = targetY;
+    table.velocityX[row] = SimulationReal();
+    table.velocityY[row] = SimulationReal();
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include "ecs.h"
+#include "framepool.h"
+#include "timerwheel.h"
+#include <algorithm>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <utility>
+#include <vector>
+
+class BehaviourScheduler;
+
+// Coroutine driving an enemy or a timed script. Starts suspended and runs
+// once handed to BehaviourScheduler::spawn, which then owns it. Frames come
+// from the scheduler's FramePool.
+class Behaviour {
+public:
+    struct promise_type;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    struct promise_type {
+        BehaviourScheduler* scheduler = nullptr;
+        EntityId entity;    // Entity the script drives, invalid for pure timed scripts
+
+        Behaviour get_return_object() { return Behaviour(Handle::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+
+        static void* operator new(size_t size) { return FramePool::allocate(size); }
+        static void operator delete(void* frame) { FramePool::deallocate(frame); }
+    };
+
+    Behaviour(Behaviour&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    Behaviour& operator=(Behaviour&&) = delete;
+    ~Behaviour() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    Handle release() { return std::exchange(handle, nullptr); }
+
+private:
+    explicit Behaviour(Handle handle) : handle(handle) {}
+    Handle handle;
+};
+
+// Resumes behaviours on the tick they asked for. Waiting behaviours sit in a
+// timing wheel, so a tick only touches the coroutines that are due.
+// Behaviours whose entity was destroyed are dropped instead of resumed.
+class BehaviourScheduler {
+public:
+    explicit BehaviourScheduler(World& world);
+    BehaviourScheduler(const BehaviourScheduler&) = delete;
+    BehaviourScheduler& operator=(const BehaviourScheduler&) = delete;
+    ~BehaviourScheduler();
+
+    // Creates script(args...) with its frame in this scheduler's pool and
+    // runs it up to its first co_await in the next tick().
+    template <typename Script, typename... Args>
+    void spawn(EntityId entity, Script&& script, Args&&... args) {
+        Behaviour::Handle handle;
+        {
+            FramePool::Scope scope(framePool);
+            handle = std::forward<Script>(script)(std::forward<Args>(args)...).release();
+        }
+        handle.promise().scheduler = this;
+        handle.promise().entity = entity;
+        ++activeCount;
+        resumeAfter(handle, 0);
+    }
+
+    // Resumes all behaviours due this tick, then advances the clock
+    void tick();
+
+    // Destroys every behaviour without resuming it
+    void clear();
+
+    // Schedules a suspended behaviour 'ticks' ticks after the next tick()
+    // (0 = next tick()). Inside tick() the clock has already moved on, so
+    // awaiters pass one less to count from the tick that is running.
+    void resumeAfter(Behaviour::Handle handle, uint32_t ticks);
+
+    uint64_t now() const { return timers.now(); }
+    size_t active() const { return activeCount; }
+    World& getWorld() { return world; }
+    const FramePool& getFramePool() const { return framePool; }
+
+private:
+    void finish(Behaviour::Handle handle);
+
+    World& world;
+    FramePool framePool;
+    size_t activeCount = 0;
+    TimerWheel<Behaviour::Handle> timers;
+    std::vector<Behaviour::Handle> running;     // Due this tick, being resumed
+};
+
+// co_await waitTicks(n): resume n ticks after the current one, 0 and 1 both
+// mean the next tick
+struct WaitTicks {
+    uint32_t ticks;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(Behaviour::Handle handle) const { handle.promise().scheduler->resumeAfter(handle, std::max(ticks, 1u) - 1); }
+    void await_resume() const noexcept {}
+};
+
+inline WaitTicks waitTicks(uint32_t ticks) { return WaitTicks{ ticks }; }
+
+// co_await reach(x, y, speed): steers the script's entity straight to (x, y)
+// and sleeps until the tick it arrives, instead of checking every tick
+struct Reach {
+    SimulationReal targetX, targetY;
+    SimulationReal speed;
+    World* world = nullptr;
+    EntityId entity;
+
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(Behaviour::Handle handle);
+    void await_resume();
+};
+
+inline Reach reach(SimulationReal x, SimulationReal y, SimulationReal speed) { return Reach{ x, y, speed, nullptr, EntityId() }; }
@@ -0,0 +1,109 @@
+// Large world tick cost, every enemy live vs sleeping chunks.
+//
+// Fills the LARGE_WORLD_CHUNKS^2 world with drifting enemies and flies the
+// player across it. The live run sends all of them through the systems every
+// tick; the chunked run keeps only the chunks around the player in the World.
+// Prints the busiest chunks of the chunked run.
+//
+//   g++ -std=c++20 -O2 -I.. bench_chunks.cpp ../chunks.cpp ../ecs.cpp ../systems.cpp -o bench_chunks
+//   ./bench_chunks [enemies] [ticks]
+
+#include "chunks.h"
+#include "ecs.h"
+#include "systems.h"
+#include "settings.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <vector>
+
+using Real = SimulationReal;
+
+struct Result {
+    double msPerTick;
+    size_t liveAtEnd;
+};
+
+static void populate(World& world, uint32_t enemyCount, Real halfWidth, Real halfHeight, Random& random) {
+    std::vector<Real> values(enemyCount * 3);
+    random.fill(values.data(), enemyCount, -halfWidth, halfWidth);
+    random.fill(values.data() + enemyCount, enemyCount, -halfHeight, halfHeight);
+    random.fill(values.data() + enemyCount * 2, enemyCount, Real(0.001f), Real(0.005f));
+
+    world.reserve(ArchetypeId::Enemy, enemyCount);
+    auto& enemies = world.table(ArchetypeId::Enemy);
+    for (uint32_t i = 0; i < enemyCount; ++i) {
+        size_t row = world.rowOf(world.create(ArchetypeId::Enemy));
+        enemies.positionX[row] = values[i];
+        enemies.positionY[row] = values[enemyCount + i];
+        enemies.driftSpeed[row] = values[enemyCount * 2 + i];
+    }
+}
+
+static Result run(uint32_t enemyCount, uint32_t ticks, ChunkMap* chunks) {
+    ChunkMap layout;
+    layout.configure(GameSettings::LARGE_WORLD_CHUNKS, GameSettings::LARGE_WORLD_CHUNKS, GameSettings::CHUNK_SIZE);
+    const Real halfWidth = layout.halfWidth();
+    const Real halfHeight = layout.halfHeight();
+
+    World world;
+    SystemScratch scratch;
+    TimerWheel<EntityId> expiries;
+    std::vector<CollisionHit<Real>> hits;
+    Random random;
+    random.setSeed(1);
+    populate(world, enemyCount, halfWidth, halfHeight, random);
+
+    // Diagonal sweep over most of the map
+    Real playerX = -halfWidth * Real(0.8f);
+    Real playerY = -halfHeight * Real(0.8f);
+    const Real step = halfWidth * Real(1.6f) / Real(static_cast<int32_t>(ticks));
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t tick = 0; tick < ticks; ++tick) {
+        steeringSystem(world, random, scratch);
+        movementSystem(world);
+        confinementSystem(world, halfWidth, halfHeight);
+        expirySystem(world, expiries, scratch);
+        hits.clear();
+        collisionSystem(world, expiries, Real(GameSettings::ENEMY_SIZE), Real(GameSettings::ENEMY_SIZE), scratch, hits);
+        if (chunks) {
+            chunks->update(world, playerX, playerY, random, tick);
+        }
+        playerX += step;
+        playerY += step;
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return { ms / ticks, world.count(ArchetypeId::Enemy) };
+}
+
+int main(int argc, char** argv) {
+    uint32_t enemies = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 200000;
+    uint32_t ticks = argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 1000;
+
+    ChunkMap chunks;
+    chunks.configure(GameSettings::LARGE_WORLD_CHUNKS, GameSettings::LARGE_WORLD_CHUNKS, GameSettings::CHUNK_SIZE);
+
+    Result live = run(enemies, ticks, nullptr);
+    Result chunked = run(enemies, ticks, &chunks);
+
+    std::printf("%u enemies, %dx%d chunks, %u ticks\n", enemies, chunks.columns(), chunks.rows(), ticks);
+    std::printf("all live  %8.4f ms/tick  %zu live\n", live.msPerTick, live.liveAtEnd);
+    std::printf("chunked   %8.4f ms/tick  %zu live, %zu asleep in %zu chunks, %llu migrations\n", chunked.msPerTick,
+        chunked.liveAtEnd, chunks.sleeping(), chunks.occupiedChunks(), static_cast<unsigned long long>(chunks.migrations()));
+    std::printf("live / chunked  %.1fx time\n", live.msPerTick / chunked.msPerTick);
+
+    // Busiest chunks by time spent in sleeping updates
+    std::vector<uint32_t> order(static_cast<size_t>(chunks.columns()) * chunks.rows());
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return chunks.stats(a).costNs > chunks.stats(b).costNs; });
+    std::printf("\n%7s %10s %8s %10s %12s\n", "chunk", "population", "updates", "cost us", "us/update");
+    for (size_t i = 0; i < std::min<size_t>(10, order.size()); ++i) {
+        const ChunkStats& stats = chunks.stats(order[i]);
+        std::printf("%3u,%-3u %10u %8llu %10.1f %12.2f\n", order[i] % chunks.columns(), order[i] / chunks.columns(), stats.population,
+            static_cast<unsigned long long>(stats.updates), stats.costNs / 1000.0, stats.updates ? stats.costNs / 1000.0 / stats.updates : 0.0);
+    }
+    return 0;
+}
@@ -0,0 +1,109 @@
+// Simulation core throughput, float build vs Fixed (Q16.16) build.
+//
+// Runs the same scene through the entity systems instantiated for each
+// number type: drifting enemies plus a steady stream of bullets with expiry
+// timers. The Fixed checksum covers every position bit, so it must match
+// across compilers, flags and machines.
+//
+//   g++ -std=c++20 -O2 -I.. bench_fixed_point.cpp ../ecs.cpp ../systems.cpp -o bench_fixed_point
+//   ./bench_fixed_point [enemies] [ticks]
+
+#include "ecs.h"
+#include "systems.h"
+#include "settings.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static constexpr int BULLETS_PER_TICK = 4;
+static constexpr int BULLET_LIFETIME = 60;
+
+static uint64_t bitsOf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static uint64_t bitsOf(Fixed value) {
+    return static_cast<uint32_t>(value.rawValue());
+}
+
+struct Result {
+    double msPerTick;
+    size_t enemiesLeft;
+    uint64_t checksum;
+};
+
+template <typename Real>
+static Result run(uint32_t enemyCount, uint32_t ticks) {
+    BasicWorld<Real> world;
+    BasicSystemScratch<Real> scratch;
+    TimerWheel<EntityId> expiries;
+    std::vector<CollisionHit<Real>> hits;
+    Random random;
+    random.setSeed(1);
+
+    const Real halfWidth(GameSettings::WORLD_WIDTH / 2);
+    const Real halfHeight(GameSettings::WORLD_HEIGHT / 2);
+    std::vector<Real> values(enemyCount * 3);
+    random.fill(values.data(), enemyCount, -halfWidth, halfWidth);
+    random.fill(values.data() + enemyCount, enemyCount, -halfHeight, halfHeight);
+    random.fill(values.data() + enemyCount * 2, enemyCount, Real(0.001f), Real(0.005f));
+
+    world.reserve(ArchetypeId::Enemy, enemyCount);
+    auto& enemies = world.table(ArchetypeId::Enemy);
+    for (uint32_t i = 0; i < enemyCount; ++i) {
+        size_t row = world.rowOf(world.create(ArchetypeId::Enemy));
+        enemies.positionX[row] = values[i];
+        enemies.positionY[row] = values[enemyCount + i];
+        enemies.driftSpeed[row] = values[enemyCount * 2 + i];
+    }
+
+    Real bulletY[BULLETS_PER_TICK];
+    auto& bullets = world.table(ArchetypeId::Bullet);
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t tick = 0; tick < ticks; ++tick) {
+        random.fill(bulletY, BULLETS_PER_TICK, -halfHeight, halfHeight);
+        for (Real y : bulletY) {
+            EntityId bullet = world.create(ArchetypeId::Bullet);
+            size_t row = world.rowOf(bullet);
+            bullets.positionX[row] = -halfWidth;
+            bullets.positionY[row] = y;
+            bullets.velocityX[row] = Real(GameSettings::BULLET_SPEED);
+            scheduleExpiry(world, expiries, bullet, BULLET_LIFETIME);
+        }
+
+        steeringSystem(world, random, scratch);
+        movementSystem(world);
+        confinementSystem(world, halfWidth, halfHeight);
+        expirySystem(world, expiries, scratch);
+        hits.clear();
+        collisionSystem(world, expiries, Real(GameSettings::SPACESHIP_SIZE), Real(GameSettings::SPACESHIP_SIZE), scratch, hits);
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t checksum = 1469598103934665603ull; // FNV-1a over all positions
+    world.forEachTable(Component::Position, [&](const auto& table) {
+        for (size_t i = 0; i < table.size(); ++i) {
+            checksum = (checksum ^ bitsOf(table.positionX[i])) * 1099511628211ull;
+            checksum = (checksum ^ bitsOf(table.positionY[i])) * 1099511628211ull;
+        }
+    });
+    return { ms / ticks, world.count(ArchetypeId::Enemy), checksum };
+}
+
+int main(int argc, char** argv) {
+    uint32_t enemies = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 20000;
+    uint32_t ticks = argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 1000;
+
+    Result floatRun = run<float>(enemies, ticks);
+    Result fixedRun = run<Fixed>(enemies, ticks);
+
+    std::printf("%u enemies, %u ticks\n", enemies, ticks);
+    std::printf("float  %8.4f ms/tick  %zu enemies left  checksum %016llx\n", floatRun.msPerTick, floatRun.enemiesLeft, static_cast<unsigned long long>(floatRun.checksum));
+    std::printf("fixed  %8.4f ms/tick  %zu enemies left  checksum %016llx\n", fixedRun.msPerTick, fixedRun.enemiesLeft, static_cast<unsigned long long>(fixedRun.checksum));
+    std::printf("fixed / float  %.2fx time\n", fixedRun.msPerTick / floatRun.msPerTick);
+    return 0;
+}
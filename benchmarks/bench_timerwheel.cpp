@@ -0,0 +1,96 @@
+// Timer wheel vs per-tick linear scan with 100k pending timers.
+//
+// Both keep the same number of timers pending: every timer that fires is
+// rescheduled, and a share of the timers is cancelled and replaced each tick,
+// the way bullets die in collisions before their expiry.
+//
+//   g++ -std=c++20 -O2 -I.. bench_timerwheel.cpp -o bench_timerwheel
+//   ./bench_timerwheel [timers] [ticks]
+
+#include "timerwheel.h"
+#include "random.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static constexpr uint32_t MAX_DELAY_TICKS = 600;    // Ten seconds at 60 Hz
+static constexpr uint32_t CANCELS_PER_TICK = 100;
+
+static uint32_t randomDelay(Random& random) {
+    return 1 + random.next() % MAX_DELAY_TICKS;
+}
+
+struct Result {
+    double msPerTick;
+    uint64_t fired;
+};
+
+// Countdown per timer, the way lifetimeSystem used to work
+static Result runLinearScan(uint32_t timers, uint32_t ticks) {
+    Random random;
+    random.setSeed(1);
+    std::vector<int32_t> remaining(timers);
+    for (auto& ticksLeft : remaining) {
+        ticksLeft = static_cast<int32_t>(randomDelay(random));
+    }
+
+    uint64_t fired = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t tick = 0; tick < ticks; ++tick) {
+        for (uint32_t i = 0; i < CANCELS_PER_TICK; ++i) {
+            remaining[random.next() % timers] = static_cast<int32_t>(randomDelay(random));
+        }
+        for (auto& ticksLeft : remaining) {
+            if (--ticksLeft <= 0) {
+                ticksLeft = static_cast<int32_t>(randomDelay(random));
+                ++fired;
+            }
+        }
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return { ms / ticks, fired };
+}
+
+static Result runTimerWheel(uint32_t timers, uint32_t ticks) {
+    Random random;
+    random.setSeed(1);
+    TimerWheel<uint32_t> wheel;
+    std::vector<TimerId> ids(timers);
+    for (uint32_t i = 0; i < timers; ++i) {
+        ids[i] = wheel.schedule(randomDelay(random) - 1, i);
+    }
+
+    std::vector<uint32_t> due;
+    uint64_t fired = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t tick = 0; tick < ticks; ++tick) {
+        for (uint32_t i = 0; i < CANCELS_PER_TICK; ++i) {
+            uint32_t timer = random.next() % timers;
+            wheel.cancel(ids[timer]);
+            ids[timer] = wheel.schedule(randomDelay(random) - 1, timer);
+        }
+        due.clear();
+        wheel.advance(due);
+        for (uint32_t timer : due) {
+            ids[timer] = wheel.schedule(randomDelay(random) - 1, timer);
+            ++fired;
+        }
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return { ms / ticks, fired };
+}
+
+int main(int argc, char** argv) {
+    uint32_t timers = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 100000;
+    uint32_t ticks = argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 6000;
+
+    Result scan = runLinearScan(timers, ticks);
+    Result wheel = runTimerWheel(timers, ticks);
+
+    std::printf("%u pending timers, %u ticks\n", timers, ticks);
+    std::printf("linear scan  %8.4f ms/tick  %llu fired\n", scan.msPerTick, static_cast<unsigned long long>(scan.fired));
+    std::printf("timer wheel  %8.4f ms/tick  %llu fired\n", wheel.msPerTick, static_cast<unsigned long long>(wheel.fired));
+    std::printf("speedup      %8.1fx\n", scan.msPerTick / wheel.msPerTick);
+    return 0;
+}
@@ -0,0 +1,264 @@
+#include "chunks.h"
+#include "settings.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+static constexpr float PI = 3.14159265358979323846f;
+
+// float uses <cmath>, Fixed its own lookup table and integer versions
+using std::cos;
+using std::floor;
+using std::sin;
+
+template <typename T>
+static void swapRemove(std::vector<T>& column, size_t row) {
+    column[row] = column.back();
+    column.pop_back();
+}
+
+template <typename Real>
+void SleepingEntities<Real>::append(Real x, Real y, Real vx, Real vy, Real speed, uint64_t tick) {
+    positionX.push_back(x);
+    positionY.push_back(y);
+    velocityX.push_back(vx);
+    velocityY.push_back(vy);
+    driftSpeed.push_back(speed);
+    updatedTick.push_back(tick);
+}
+
+template <typename Real>
+void SleepingEntities<Real>::removeRow(size_t row) {
+    swapRemove(positionX, row);
+    swapRemove(positionY, row);
+    swapRemove(velocityX, row);
+    swapRemove(velocityY, row);
+    swapRemove(driftSpeed, row);
+    swapRemove(updatedTick, row);
+}
+
+template <typename Real>
+void SleepingEntities<Real>::clear() {
+    positionX.clear();
+    positionY.clear();
+    velocityX.clear();
+    velocityY.clear();
+    driftSpeed.clear();
+    updatedTick.clear();
+}
+
+template <typename Real>
+void BasicChunkMap<Real>::configure(int columnCount, int rowCount, float chunkSize) {
+    chunksX = std::max(1, columnCount);
+    chunksY = std::max(1, rowCount);
+    worldHalfWidth = Real(chunksX * chunkSize / 2);
+    worldHalfHeight = Real(chunksY * chunkSize / 2);
+    inverseChunkSize = Real(1.0f / chunkSize);
+    chunks.assign(static_cast<size_t>(chunksX) * chunksY, Chunk());
+    clear();
+}
+
+template <typename Real>
+void BasicChunkMap<Real>::clear() {
+    for (Chunk& chunk : chunks) {
+        chunk.sleepers.clear();
+        chunk.lastUpdate = 0;
+        chunk.occupied = false;
+        chunk.stats = ChunkStats();
+    }
+    occupied.clear();
+    playerChunkX = playerChunkY = 0;
+    sleepingCount = 0;
+    migrationCount = 0;
+}
+
+template <typename Real>
+int BasicChunkMap<Real>::chunkX(Real x) const {
+    int column = static_cast<int>(static_cast<float>(floor((x + worldHalfWidth) * inverseChunkSize)));
+    return std::clamp(column, 0, chunksX - 1);
+}
+
+template <typename Real>
+int BasicChunkMap<Real>::chunkY(Real y) const {
+    int row = static_cast<int>(static_cast<float>(floor((y + worldHalfHeight) * inverseChunkSize)));
+    return std::clamp(row, 0, chunksY - 1);
+}
+
+template <typename Real>
+int BasicChunkMap<Real>::distanceToPlayer(uint32_t chunk) const {
+    int column = static_cast<int>(chunk % chunksX);
+    int row = static_cast<int>(chunk / chunksX);
+    return std::max(std::abs(column - playerChunkX), std::abs(row - playerChunkY));
+}
+
+template <typename Real>
+bool BasicChunkMap<Real>::isActive(uint32_t chunk) const {
+    return distanceToPlayer(chunk) <= GameSettings::CHUNK_ACTIVE_RADIUS;
+}
+
+template <typename Real>
+Real BasicChunkMap<Real>::activeReach(Real playerX, bool right) const {
+    const int column = chunkX(playerX) + (right ? GameSettings::CHUNK_ACTIVE_RADIUS + 1 : -GameSettings::CHUNK_ACTIVE_RADIUS);
+    const Real edge = Real(column * GameSettings::CHUNK_SIZE) - worldHalfWidth;
+    return right ? edge - playerX : playerX - edge;
+}
+
+template <typename Real>
+void BasicChunkMap<Real>::addSleeper(uint32_t index, Real x, Real y, Real vx, Real vy, Real speed, uint64_t tick) {
+    Chunk& chunk = chunks[index];
+    if (!chunk.occupied) {
+        chunk.occupied = true;
+        chunk.lastUpdate = tick;
+        occupied.push_back(index);
+    }
+    chunk.sleepers.append(x, y, vx, vy, speed, tick);
+    ++sleepingCount;
+}
+
+template <typename Real>
+static void spawnLive(BasicWorld<Real>& world, Real x, Real y, Real vx, Real vy, Real speed) {
+    EntityId enemy = world.create(ArchetypeId::Enemy);
+    BasicArchetypeTable<Real>& enemies = world.table(ArchetypeId::Enemy);
+    size_t row = world.rowOf(enemy);
+    enemies.positionX[row] = x;
+    enemies.positionY[row] = y;
+    enemies.velocityX[row] = vx;
+    enemies.velocityY[row] = vy;
+    enemies.driftSpeed[row] = speed;
+}
+
+template <typename Real>
+void BasicChunkMap<Real>::update(BasicWorld<Real>& world, Real playerX, Real playerY, Random& random, uint64_t tick) {
+    if (chunks.empty()) {
+        return;
+    }
+    const int radius = GameSettings::CHUNK_ACTIVE_RADIUS;
+
+    // Live populations are recounted every tick, in the old and the new active area
+    auto resetLivePopulation = [&] {
+        for (int row = std::max(0, playerChunkY - radius); row <= std::min(chunksY - 1, playerChunkY + radius); ++row) {
+            for (int column = std::max(0, playerChunkX - radius); column <= std::min(chunksX - 1, playerChunkX + radius); ++column) {
+                chunks[static_cast<size_t>(row) * chunksX + column].stats.population = 0;
+            }
+        }
+    };
+    resetLivePopulation();
+    playerChunkX = chunkX(playerX);
+    playerChunkY = chunkY(playerY);
+    resetLivePopulation();
+
+    // Live enemies outside the active area fall asleep where they are
+    BasicArchetypeTable<Real>& enemies = world.table(ArchetypeId::Enemy);
+    doomed.clear();
+    for (size_t row = 0; row < enemies.size(); ++row) {
+        const int column = chunkX(enemies.positionX[row]);
+        const int chunkRow = chunkY(enemies.positionY[row]);
+        const uint32_t index = static_cast<uint32_t>(chunkRow * chunksX + column);
+        if (std::abs(column - playerChunkX) <= radius && std::abs(chunkRow - playerChunkY) <= radius) {
+            ++chunks[index].stats.population;
+            continue;
+        }
+        addSleeper(index, enemies.positionX[row], enemies.positionY[row], enemies.velocityX[row], enemies.velocityY[row], enemies.driftSpeed[row], tick);
+        doomed.push_back(world.entityAt(ArchetypeId::Enemy, row));
+    }
+    for (EntityId id : doomed) {
+        world.destroy(id);
+    }
+    migrationCount += doomed.size();
+
+    // Sleeping chunks: woken when active, otherwise updated at their distance's rate
+    for (size_t i = 0; i < occupied.size();) {
+        const uint32_t index = occupied[i];
+        Chunk& chunk = chunks[index];
+        const int distance = distanceToPlayer(index);
+        const uint64_t interval = distance <= GameSettings::CHUNK_NEAR_RADIUS ? GameSettings::CHUNK_NEAR_INTERVAL : GameSettings::CHUNK_FAR_INTERVAL;
+
+        if (distance <= radius || tick - chunk.lastUpdate >= interval) {
+            auto start = std::chrono::steady_clock::now();
+            advance(world, index, random, tick);
+            if (distance <= radius) {
+                wake(world, chunk);
+            }
+            chunk.stats.costNs += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+            ++chunk.stats.updates;
+        }
+
+        if (chunk.sleepers.size() == 0) {
+            chunk.occupied = false;
+            occupied[i] = occupied.back();
+            occupied.pop_back();
+            continue;
+        }
+        ++i;
+    }
+}
+
+// Brings every sleeper of the chunk up to 'tick' in one step of however many
+// ticks it missed: one steering roll for the whole span (the chance of a new
+// heading grows about linearly with it), then straight-line movement.
+template <typename Real>
+void BasicChunkMap<Real>::advance(BasicWorld<Real>& world, uint32_t index, Random& random, uint64_t tick) {
+    Chunk& chunk = chunks[index];
+    SleepingEntities<Real>& sleepers = chunk.sleepers;
+    const size_t count = sleepers.size();
+
+    randomBuffer.resize(count * 2);
+    Real* roll = randomBuffer.data();
+    Real* angle = roll + count;
+    random.fill(roll, count, Real(0), Real(1));
+    random.fill(angle, count, Real(0), Real(2.0f * PI));
+
+    const Real chance(GameSettings::STEERING_CHANCE);
+    for (size_t i = 0; i < count; ++i) {
+        const uint64_t elapsed = tick - sleepers.updatedTick[i];
+        if (elapsed == 0) {
+            continue;
+        }
+        const Real steps(static_cast<int32_t>(elapsed));
+        if (roll[i] < chance * steps) {
+            sleepers.velocityX[i] = cos(angle[i]) * sleepers.driftSpeed[i];
+            sleepers.velocityY[i] = sin(angle[i]) * sleepers.driftSpeed[i];
+        }
+        sleepers.positionX[i] = std::clamp(sleepers.positionX[i] + sleepers.velocityX[i] * steps, -worldHalfWidth, worldHalfWidth);
+        sleepers.positionY[i] = std::clamp(sleepers.positionY[i] + sleepers.velocityY[i] * steps, -worldHalfHeight, worldHalfHeight);
+        sleepers.updatedTick[i] = tick;
+    }
+    chunk.lastUpdate = tick;
+
+    // Sleepers that drifted across the border move on, straight into the World
+    // if the chunk they entered is live
+    for (size_t i = 0; i < sleepers.size();) {
+        const uint32_t target = chunkAt(sleepers.positionX[i], sleepers.positionY[i]);
+        if (target == index) {
+            ++i;
+            continue;
+        }
+        if (isActive(target)) {
+            spawnLive(world, sleepers.positionX[i], sleepers.positionY[i], sleepers.velocityX[i], sleepers.velocityY[i], sleepers.driftSpeed[i]);
+            ++migrationCount;
+        }
+        else {
+            addSleeper(target, sleepers.positionX[i], sleepers.positionY[i], sleepers.velocityX[i], sleepers.velocityY[i], sleepers.driftSpeed[i], tick);
+        }
+        sleepers.removeRow(i);
+        --sleepingCount;
+    }
+    chunk.stats.population = static_cast<uint32_t>(sleepers.size());
+}
+
+template <typename Real>
+void BasicChunkMap<Real>::wake(BasicWorld<Real>& world, Chunk& chunk) {
+    SleepingEntities<Real>& sleepers = chunk.sleepers;
+    for (size_t i = 0; i < sleepers.size(); ++i) {
+        spawnLive(world, sleepers.positionX[i], sleepers.positionY[i], sleepers.velocityX[i], sleepers.velocityY[i], sleepers.driftSpeed[i]);
+    }
+    sleepingCount -= sleepers.size();
+    migrationCount += sleepers.size();
+    sleepers.clear();
+}
+
+template struct SleepingEntities<float>;
+template struct SleepingEntities<Fixed>;
+template class BasicChunkMap<float>;
+template class BasicChunkMap<Fixed>;
@@ -0,0 +1,103 @@
+#pragma once
+#include "ecs.h"
+#include "random.h"
+#include <cstdint>
+#include <vector>
+
+// Large-world mode: the world is a grid of square chunks centered on the
+// origin. Chunks within CHUNK_ACTIVE_RADIUS of the player's chunk are live:
+// their entities are in the World and go through every system each tick.
+// Drifting enemies anywhere else sleep in their chunk, outside the World,
+// and are advanced in bulk every few ticks, less often the further away they
+// are. Chunks without sleepers are never visited.
+//
+// Crossing a chunk border works in both directions: a live enemy leaving the
+// active area falls asleep in its new chunk, and a sleeper entering it (or
+// whose chunk becomes active) wakes up with its state caught up to the
+// current tick. Only plain Enemy entities sleep. They get a new EntityId
+// every time they wake, so nothing may hold on to one.
+
+struct ChunkStats {
+    uint32_t population = 0;    // Drifting enemies at the last visit, live or asleep
+    uint64_t updates = 0;       // Sleeping updates run
+    uint64_t costNs = 0;        // Time spent in them. Live chunks are paid for by the systems.
+};
+
+// Sleeping enemies of one chunk, same columns as the Enemy table
+template <typename Real>
+struct SleepingEntities {
+    std::vector<Real> positionX, positionY;
+    std::vector<Real> velocityX, velocityY;
+    std::vector<Real> driftSpeed;
+    std::vector<uint64_t> updatedTick;  // Row state is current as of this tick
+
+    size_t size() const { return positionX.size(); }
+    void append(Real x, Real y, Real vx, Real vy, Real speed, uint64_t tick);
+    void removeRow(size_t row);
+    void clear();
+};
+
+template <typename Real>
+class BasicChunkMap {
+public:
+    // chunksX * chunksY chunks with sides of chunkSize; drops all sleepers
+    void configure(int chunksX, int chunksY, float chunkSize);
+    void clear();
+
+    Real halfWidth() const { return worldHalfWidth; }
+    Real halfHeight() const { return worldHalfHeight; }
+    int columns() const { return chunksX; }
+    int rows() const { return chunksY; }
+
+    // Chunk holding the position, clamped into the map
+    uint32_t chunkAt(Real x, Real y) const { return static_cast<uint32_t>(chunkY(y) * chunksX + chunkX(x)); }
+
+    // Once per tick after the systems: puts the enemies that left the active
+    // area to sleep, wakes the chunks that entered it and runs the sleeping
+    // updates that are due.
+    void update(BasicWorld<Real>& world, Real playerX, Real playerY, Random& random, uint64_t tick);
+
+    const ChunkStats& stats(uint32_t chunk) const { return chunks[chunk].stats; }
+    bool isActive(uint32_t chunk) const;
+    // Distance from the player at x to the edge of the active area, to the
+    // right or left. Anything further away is asleep.
+    Real activeReach(Real playerX, bool right) const;
+    size_t sleeping() const { return sleepingCount; }
+    size_t occupiedChunks() const { return occupied.size(); }
+    uint64_t migrations() const { return migrationCount; }   // Enemies that fell asleep or woke up
+
+private:
+    struct Chunk {
+        SleepingEntities<Real> sleepers;
+        uint64_t lastUpdate = 0;
+        bool occupied = false;
+        ChunkStats stats;
+    };
+
+    int chunkX(Real x) const;
+    int chunkY(Real y) const;
+    int distanceToPlayer(uint32_t chunk) const;
+    void addSleeper(uint32_t chunk, Real x, Real y, Real vx, Real vy, Real speed, uint64_t tick);
+    void advance(BasicWorld<Real>& world, uint32_t index, Random& random, uint64_t tick);
+    void wake(BasicWorld<Real>& world, Chunk& chunk);
+
+    std::vector<Chunk> chunks;
+    std::vector<uint32_t> occupied;     // Chunks with sleepers, unordered
+    int chunksX = 0, chunksY = 0;
+    Real worldHalfWidth{}, worldHalfHeight{};
+    Real inverseChunkSize{};
+    int playerChunkX = 0, playerChunkY = 0;
+    size_t sleepingCount = 0;
+    uint64_t migrationCount = 0;
+
+    // Reused from update to update
+    std::vector<Real> randomBuffer;
+    std::vector<EntityId> doomed;
+};
+
+extern template struct SleepingEntities<float>;
+extern template struct SleepingEntities<Fixed>;
+extern template class BasicChunkMap<float>;
+extern template class BasicChunkMap<Fixed>;
+
+using ChunkMap = BasicChunkMap<SimulationReal>;
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "fixed.h"
+
+// Number type the simulation core is built with. Define GAME_FIXED_POINT for
+// the deterministic Q16.16 build (lockstep, replays checked across machines).
+#ifdef GAME_FIXED_POINT
+using SimulationReal = Fixed;
+#else
+using SimulationReal = float;
+#endif
+
+// Sprite kinds known to the renderer
+enum class SpriteId : uint8_t { Enemy, Bullet, Explosion, Count };
+constexpr size_t SPRITE_COUNT = static_cast<size_t>(SpriteId::Count);
+
+// Entity layouts. Every archetype has its own table in the World.
+enum class ArchetypeId : uint8_t { Enemy, ScriptedEnemy, Bullet, Explosion, Count };
+constexpr size_t ARCHETYPE_COUNT = static_cast<size_t>(ArchetypeId::Count);
+
+// Component bits. An archetype is the set of components its entities carry;
+// data components own a column in the archetype table, tags are just a bit.
+using ComponentMask = uint32_t;
+
+namespace Component {
+    constexpr ComponentMask Position   = 1u << 0; // positionX, positionY
+    constexpr ComponentMask Velocity   = 1u << 1; // velocityX, velocityY
+    constexpr ComponentMask Sprite     = 1u << 2; // spriteFrame, the sprite id is per table
+    constexpr ComponentMask Lifetime   = 1u << 3; // destroyed when its expiry timer fires
+    constexpr ComponentMask Drift      = 1u << 4; // driftSpeed, random steering confined to the world
+    constexpr ComponentMask Animated   = 1u << 5; // Tag: spriteFrame advances every tick
+    constexpr ComponentMask Projectile = 1u << 6; // Tag: destroys the first Target it overlaps
+    constexpr ComponentMask Target     = 1u << 7; // Tag: can be hit by projectiles
+}
+
+// Stable handle to an entity. The generation tells a recycled slot from the
+// entity that used it before.
+struct EntityId {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool operator==(const EntityId& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const EntityId& other) const { return !(*this == other); }
+};
@@ -0,0 +1,185 @@
+#include "ecs.h"
+
+template <typename Real>
+void BasicArchetypeTable<Real>::reserve(size_t rows) {
+    entity.reserve(rows);
+    if (mask & Component::Position) {
+        positionX.reserve(rows);
+        positionY.reserve(rows);
+    }
+    if (mask & Component::Velocity) {
+        velocityX.reserve(rows);
+        velocityY.reserve(rows);
+    }
+    if (mask & Component::Drift) {
+        driftSpeed.reserve(rows);
+    }
+    if (mask & Component::Lifetime) {
+        expiry.reserve(rows);
+    }
+    if (mask & Component::Sprite) {
+        spriteFrame.reserve(rows);
+    }
+}
+
+template <typename Real>
+size_t BasicArchetypeTable<Real>::appendRow(uint32_t entityIndex) {
+    entity.push_back(entityIndex);
+    if (mask & Component::Position) {
+        positionX.push_back(Real());
+        positionY.push_back(Real());
+    }
+    if (mask & Component::Velocity) {
+        velocityX.push_back(Real());
+        velocityY.push_back(Real());
+    }
+    if (mask & Component::Drift) {
+        driftSpeed.push_back(Real());
+    }
+    if (mask & Component::Lifetime) {
+        expiry.push_back(TimerId());
+    }
+    if (mask & Component::Sprite) {
+        spriteFrame.push_back(0);
+    }
+    return entity.size() - 1;
+}
+
+template <typename T>
+static void swapRemove(std::vector<T>& column, size_t row) {
+    if (column.empty()) {
+        return;
+    }
+    column[row] = column.back();
+    column.pop_back();
+}
+
+template <typename Real>
+void BasicArchetypeTable<Real>::removeRow(size_t row) {
+    swapRemove(entity, row);
+    swapRemove(positionX, row);
+    swapRemove(positionY, row);
+    swapRemove(velocityX, row);
+    swapRemove(velocityY, row);
+    swapRemove(driftSpeed, row);
+    swapRemove(expiry, row);
+    swapRemove(spriteFrame, row);
+}
+
+template <typename Real>
+void BasicArchetypeTable<Real>::clear() {
+    entity.clear();
+    positionX.clear();
+    positionY.clear();
+    velocityX.clear();
+    velocityY.clear();
+    driftSpeed.clear();
+    expiry.clear();
+    spriteFrame.clear();
+}
+
+template <typename Real>
+BasicWorld<Real>::BasicWorld() {
+    using namespace Component;
+
+    for (size_t i = 0; i < ARCHETYPE_COUNT; ++i) {
+        tables[i].archetype = static_cast<ArchetypeId>(i);
+    }
+
+    ArchetypeTable& enemies = table(ArchetypeId::Enemy);
+    enemies.mask = Position | Velocity | Sprite | Drift | Target;
+    enemies.sprite = SpriteId::Enemy;
+
+    // Moved by behaviour scripts instead of random drift
+    ArchetypeTable& scriptedEnemies = table(ArchetypeId::ScriptedEnemy);
+    scriptedEnemies.mask = Position | Velocity | Sprite | Target;
+    scriptedEnemies.sprite = SpriteId::Enemy;
+
+    ArchetypeTable& bullets = table(ArchetypeId::Bullet);
+    bullets.mask = Position | Velocity | Sprite | Lifetime | Projectile;
+    bullets.sprite = SpriteId::Bullet;
+
+    ArchetypeTable& explosions = table(ArchetypeId::Explosion);
+    explosions.mask = Position | Sprite | Lifetime | Animated;
+    explosions.sprite = SpriteId::Explosion;
+}
+
+template <typename Real>
+EntityId BasicWorld<Real>::create(ArchetypeId archetype) {
+    uint32_t index;
+    if (!freeIndices.empty()) {
+        index = freeIndices.back();
+        freeIndices.pop_back();
+    }
+    else {
+        index = static_cast<uint32_t>(records.size());
+        records.emplace_back();
+    }
+
+    EntityRecord& record = records[index];
+    record.archetype = archetype;
+    record.row = static_cast<uint32_t>(table(archetype).appendRow(index));
+    record.alive = true;
+    return EntityId{ index, record.generation };
+}
+
+template <typename Real>
+void BasicWorld<Real>::destroy(EntityId id) {
+    if (!isAlive(id)) {
+        return;
+    }
+
+    EntityRecord& record = records[id.index];
+    ArchetypeTable& archetypeTable = table(record.archetype);
+    size_t row = record.row;
+    archetypeTable.removeRow(row);
+
+    // The last row was moved into the hole
+    if (row < archetypeTable.size()) {
+        records[archetypeTable.entity[row]].row = static_cast<uint32_t>(row);
+    }
+
+    record.alive = false;
+    ++record.generation;
+    freeIndices.push_back(id.index);
+}
+
+template <typename Real>
+bool BasicWorld<Real>::isAlive(EntityId id) const {
+    return id.index < records.size() && records[id.index].alive && records[id.index].generation == id.generation;
+}
+
+template <typename Real>
+size_t BasicWorld<Real>::rowOf(EntityId id) const {
+    return records[id.index].row;
+}
+
+template <typename Real>
+ArchetypeId BasicWorld<Real>::archetypeOf(EntityId id) const {
+    return records[id.index].archetype;
+}
+
+template <typename Real>
+EntityId BasicWorld<Real>::entityAt(ArchetypeId archetype, size_t row) const {
+    uint32_t index = table(archetype).entity[row];
+    return EntityId{ index, records[index].generation };
+}
+
+template <typename Real>
+void BasicWorld<Real>::reserve(ArchetypeId archetype, size_t rows) {
+    table(archetype).reserve(rows);
+}
+
+template <typename Real>
+void BasicWorld<Real>::clear() {
+    for (auto& archetypeTable : tables) {
+        archetypeTable.clear();
+    }
+    records.clear();
+    freeIndices.clear();
+}
+
+template struct BasicArchetypeTable<float>;
+template struct BasicArchetypeTable<Fixed>;
+template class BasicWorld<float>;
+template class BasicWorld<Fixed>;
@@ -0,0 +1,93 @@
+#pragma once
+#include "components.h"
+#include "timerwheel.h"
+#include <vector>
+#include <cstdint>
+
+// Structure-of-arrays storage for all entities of one archetype. Only the
+// columns of components in the mask are used; all used columns have one
+// entry per row. Rows are kept dense by swap-removal.
+// Real is the number type of positions and velocities: float or Fixed.
+template <typename Real>
+struct BasicArchetypeTable {
+    ArchetypeId archetype = ArchetypeId::Enemy;
+    ComponentMask mask = 0;
+    SpriteId sprite = SpriteId::Enemy;
+
+    std::vector<uint32_t> entity;       // Row -> entity index, for destroy()
+    std::vector<Real> positionX, positionY;
+    std::vector<Real> velocityX, velocityY;
+    std::vector<Real> driftSpeed;
+    std::vector<TimerId> expiry;        // Pending expiry timer, see expirySystem
+    std::vector<uint8_t> spriteFrame;
+
+    size_t size() const { return entity.size(); }
+    bool has(ComponentMask components) const { return (mask & components) == components; }
+
+    void reserve(size_t rows);
+    size_t appendRow(uint32_t entityIndex);
+    void removeRow(size_t row);
+    void clear();
+};
+
+// Entity registry plus one table per archetype
+template <typename Real>
+class BasicWorld {
+public:
+    using ArchetypeTable = BasicArchetypeTable<Real>;
+
+    BasicWorld();
+
+    EntityId create(ArchetypeId archetype);
+    void destroy(EntityId id);
+    bool isAlive(EntityId id) const;
+    size_t rowOf(EntityId id) const;
+    ArchetypeId archetypeOf(EntityId id) const;
+    EntityId entityAt(ArchetypeId archetype, size_t row) const;
+
+    ArchetypeTable& table(ArchetypeId archetype) { return tables[static_cast<size_t>(archetype)]; }
+    const ArchetypeTable& table(ArchetypeId archetype) const { return tables[static_cast<size_t>(archetype)]; }
+    size_t count(ArchetypeId archetype) const { return table(archetype).size(); }
+    void reserve(ArchetypeId archetype, size_t rows);
+    void clear();
+
+    // Calls fn(ArchetypeTable&) for every non-empty table carrying all required components
+    template <typename Fn>
+    void forEachTable(ComponentMask required, Fn&& fn) {
+        for (auto& archetypeTable : tables) {
+            if (archetypeTable.has(required) && archetypeTable.size() > 0) {
+                fn(archetypeTable);
+            }
+        }
+    }
+
+    template <typename Fn>
+    void forEachTable(ComponentMask required, Fn&& fn) const {
+        for (const auto& archetypeTable : tables) {
+            if (archetypeTable.has(required) && archetypeTable.size() > 0) {
+                fn(archetypeTable);
+            }
+        }
+    }
+
+private:
+    struct EntityRecord {
+        uint32_t generation = 0;
+        uint32_t row = 0;
+        ArchetypeId archetype = ArchetypeId::Enemy;
+        bool alive = false;
+    };
+
+    ArchetypeTable tables[ARCHETYPE_COUNT];
+    std::vector<EntityRecord> records;
+    std::vector<uint32_t> freeIndices;
+};
+
+// Instantiated for float and Fixed in ecs.cpp
+extern template struct BasicArchetypeTable<float>;
+extern template struct BasicArchetypeTable<Fixed>;
+extern template class BasicWorld<float>;
+extern template class BasicWorld<Fixed>;
+
+using ArchetypeTable = BasicArchetypeTable<SimulationReal>;
+using World = BasicWorld<SimulationReal>;
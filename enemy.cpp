@@ -1,88 +1,177 @@
 #include "enemy.h"
 #include "settings.h"
-#include <qmath.h>
-#include <QDebug>
-
-void EnemyManager::createRandomEnemySpaceship() {
-    float randomX, randomY;
-    generateRandomCoordinates(randomX, randomY);
-
-    float randomVelocity = generateRandomVelocity(0.001f, 0.005f);
-    EnemySpaceship enemy(randomX, randomY, randomVelocity);
-    qDebug() << "Enemy spaceship created at position: (" << enemy.x << "," << enemy.y << ") with size: " << GameSettings::SPACESHIP_SIZE;
-    enemySpaceships.push_back(enemy);
-}
-
-float EnemyManager::getRandomFloat(float min, float max) {
-    return min + static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * (max - min);
-}
-
-void EnemyManager::generateRandomCoordinates(float& x, float& y) {
-    x = getRandomFloat(-GameSettings::WORLD_WIDTH / 2, GameSettings::WORLD_WIDTH / 2);
-    y = getRandomFloat(-GameSettings::WORLD_HEIGHT / 2, GameSettings::WORLD_HEIGHT / 2);
+#include <algorithm>
+#include <cmath>
+#include <cctype>
+#include <sstream>
+#include <string>
+
+static constexpr float PI = 3.14159265358979323846f;
+
+using Real = SimulationReal;
+using std::cos;
+using std::sin;
+
+void EnemyManager::createRandomEnemySpaceship(World& world) {
+    WaveDescription single;
+    single.count = 1;
+    spawnWave(world, single);
 }
 
+// Spawns a whole wave in one go: storage is grown once up front and all random
+// numbers the wave needs are drawn as a single batch before the enemies are built.
+void EnemyManager::spawnWave(World& world, const WaveDescription& wave, std::vector<ScriptedSpawn>* scripted) {
+    if (wave.count <= 0) {
+        return;
+    }
+    const size_t count = static_cast<size_t>(wave.count);
+
+    // x, y and speed for every enemy of the wave
+    randomBuffer.resize(count * 3);
+    const Real halfWidth(boundsHalfWidth);
+    const Real halfHeight(boundsHalfHeight);
+    Real* randomX = randomBuffer.data();
+    Real* randomY = randomX + count;
+    Real* randomSpeed = randomY + count;
+    random.fill(randomX, count, -halfWidth, halfWidth);
+    random.fill(randomY, count, -halfHeight, halfHeight);
+    random.fill(randomSpeed, count, Real(wave.minSpeed), Real(wave.maxSpeed));
+
+    // Formations are laid out around the first random position
+    const Real centerX = randomX[0];
+    const Real centerY = randomY[0];
+    const Real spacing(GameSettings::ENEMY_SIZE);
+    const Real twoPi(2.0f * PI);
+    size_t columns = 1;
+    while (columns * columns < count) {
+        ++columns;
+    }
+    const size_t rows = (count + columns - 1) / columns;
+    const Real radius = std::max(spacing, Real(count) * spacing / twoPi);
+    const Real half(0.5f);
+
+    // Grow geometrically so repeated waves don't reallocate every time
+    const ArchetypeId archetype = wave.formation == Formation::Patrol ? ArchetypeId::ScriptedEnemy : ArchetypeId::Enemy;
+    ArchetypeTable& enemies = world.table(archetype);
+    const size_t required = enemies.size() + count;
+    if (enemies.entity.capacity() < required) {
+        world.reserve(archetype, std::max(required, enemies.entity.capacity() * 2));
+    }
 
-float EnemyManager::generateRandomVelocity(float minVelocity, float maxVelocity) {
-    return getRandomFloat(minVelocity, maxVelocity);
-}
-
-void EnemyManager::update() {
-    for (auto& enemy : enemySpaceships) {
-
-        // Direction
-        if (rand() % 100 < 5) {
-            float angle = static_cast<float>(rand()) / RAND_MAX * 2 * M_PI;
-            enemy.velocityX = cos(angle) * enemy.speed;
-            enemy.velocityY = sin(angle) * enemy.speed;
+    for (size_t i = 0; i < count; ++i) {
+        Real x = randomX[i];
+        Real y = randomY[i];
+
+        switch (wave.formation) {
+        case Formation::Line:
+            x = centerX + (Real(i) - Real(count - 1) * half) * spacing;
+            y = centerY;
+            break;
+        case Formation::Column:
+        case Formation::Patrol:
+            x = centerX;
+            y = centerY + (Real(i) - Real(count - 1) * half) * spacing;
+            break;
+        case Formation::Circle: {
+            Real angle = twoPi * Real(i) / Real(count);
+            x = centerX + cos(angle) * radius;
+            y = centerY + sin(angle) * radius;
+            break;
+        }
+        case Formation::Grid:
+            x = centerX + (Real(i % columns) - Real(columns - 1) * half) * spacing;
+            y = centerY + (Real(i / columns) - Real(rows - 1) * half) * spacing;
+            break;
+        case Formation::Random:
+        default:
+            break;
         }
 
-        enemy.x += enemy.velocityX;
-        enemy.y += enemy.velocityY;
-
-        enemy.x = qBound(-GameSettings::WORLD_WIDTH / 2, enemy.x, GameSettings::WORLD_WIDTH / 2);
-        enemy.y = qBound(-GameSettings::WORLD_HEIGHT / 2, enemy.y, GameSettings::WORLD_HEIGHT / 2);
-
-        //handleBoundary(enemy);
-
-        qDebug() << "Enemy position: " << enemy.x << ", " << enemy.y;
+        EntityId enemy = world.create(archetype);
+        size_t row = world.rowOf(enemy);
+        enemies.positionX[row] = std::clamp(x, -halfWidth, halfWidth);
+        enemies.positionY[row] = std::clamp(y, -halfHeight, halfHeight);
+        if (enemies.has(Component::Drift)) {
+            enemies.driftSpeed[row] = randomSpeed[i];
+        }
+        else if (scripted) {
+            scripted->push_back({ enemy, randomSpeed[i] });
+        }
     }
 }
 
-bool EnemyManager::checkCollision(const Spacecraft& playerSpaceship) {
-
-    QRectF playerRect = playerSpaceship.getBoundingBox();
-
-    for (const auto& enemy : enemySpaceships) {
-        float enemyWidth = GameSettings::ENEMY_SIZE;
-        float enemyHeight = enemyWidth / enemyAspectRatio; // Assume enemyAspectRatio is defined
-
-        QRectF enemyRect(enemy.x - enemyWidth / 2, enemy.y - enemyHeight / 2, enemyWidth, enemyHeight);
+// Spawns the next wave of the loaded wave table, wrapping around at the end
+void EnemyManager::spawnNextWave(World& world, std::vector<ScriptedSpawn>* scripted) {
+    if (waves.empty()) {
+        return;
+    }
+    spawnWave(world, waves[nextWave % waves.size()], scripted);
+    ++nextWave;
+}
 
-        if (playerRect.intersects(enemyRect)) {
-            return true;
+// Loads the wave table. One wave per line: <count> <formation> <minSpeed> <maxSpeed>
+// Empty lines and lines starting with '#' are ignored. A bad line rejects the
+// whole table, error says which.
+bool EnemyManager::loadWaves(std::istream& in, std::string& error) {
+    waves.clear();
+    nextWave = 0;
+    error.clear();
+
+    std::string line;
+    for (int lineNumber = 1; std::getline(in, line); ++lineNumber) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
         }
-    }
 
-    return false;
-}
+        std::istringstream fields(line);
+        WaveDescription wave;
+        std::string formation;
+        if (!(fields >> wave.count >> formation >> wave.minSpeed >> wave.maxSpeed) || !(fields >> std::ws).eof()) {
+            error = "line " + std::to_string(lineNumber) + ": expected <count> <formation> <minSpeed> <maxSpeed>";
+        }
+        else if (wave.count < 0 || wave.count > GameSettings::MAX_WAVE_SIZE) {
+            error = "line " + std::to_string(lineNumber) + ": count must be 0 to " + std::to_string(GameSettings::MAX_WAVE_SIZE);
+        }
+        else if (wave.minSpeed > wave.maxSpeed) {
+            error = "line " + std::to_string(lineNumber) + ": minSpeed is above maxSpeed";
+        }
+        if (!error.empty()) {
+            waves.clear();
+            return false;
+        }
 
-void EnemyManager::handleBoundary(EnemySpaceship& enemy) {
-    if (enemy.x < -GameSettings::WORLD_WIDTH / 2) {
-        enemy.x = -GameSettings::WORLD_WIDTH / 2;
-        enemy.velocityX = -enemy.velocityX;
-    }
-    else if (enemy.x > GameSettings::WORLD_WIDTH / 2) {
-        enemy.x = GameSettings::WORLD_WIDTH / 2;
-        enemy.velocityX = -enemy.velocityX;
+        std::string name = formation;
+        std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (name == "line") {
+            wave.formation = Formation::Line;
+        }
+        else if (name == "column") {
+            wave.formation = Formation::Column;
+        }
+        else if (name == "circle") {
+            wave.formation = Formation::Circle;
+        }
+        else if (name == "grid") {
+            wave.formation = Formation::Grid;
+        }
+        else if (name == "patrol") {
+            wave.formation = Formation::Patrol;
+        }
+        else if (name == "random") {
+            wave.formation = Formation::Random;
+        }
+        else {
+            error = "line " + std::to_string(lineNumber) + ": unknown formation '" + formation + "'";
+            waves.clear();
+            return false;
+        }
+        waves.push_back(wave);
     }
 
-    if (enemy.y < -GameSettings::WORLD_HEIGHT / 2) {
-        enemy.y = -GameSettings::WORLD_HEIGHT / 2;
-        enemy.velocityY = -enemy.velocityY;
-    }
-    else if (enemy.y > GameSettings::WORLD_HEIGHT / 2) {
-        enemy.y = GameSettings::WORLD_HEIGHT / 2;
-        enemy.velocityY = -enemy.velocityY;
+    if (waves.empty()) {
+        error = "no waves";
+        return false;
     }
+    return true;
 }
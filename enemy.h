@@ -1,31 +1,48 @@
 #pragma once
-#include "player.h"
+#include "ecs.h"
+#include "random.h"
+#include "settings.h"
 #include <vector>
-#include <cstdlib>
+#include <istream>
+#include <string>
 
-class EnemySpaceship {
-public:
-    float x;
-    float y;
-    float velocityX, velocityY; // Velocity components
-    float speed; // Speed of spaceship
-    float moveX; // X-direction movement
-    float moveY; // Y-direction movement
-    float width;
-    float height;
+// Layout of the enemies spawned by a single wave
+enum class Formation { Random, Line, Column, Circle, Grid, Patrol };
 
-    EnemySpaceship(float posX, float posY, float vel) : x(posX), y(posY), speed(vel), velocityX(0), velocityY(0) {}
+// One entry of the wave table (see waves.txt)
+struct WaveDescription {
+    int count = 0;
+    Formation formation = Formation::Random;
+    float minSpeed = 0.001f;
+    float maxSpeed = 0.005f;
 };
 
+// Enemy that needs a behaviour script to move
+struct ScriptedSpawn {
+    EntityId entity;
+    SimulationReal speed;
+};
 
+// Creates enemy entities in the World, one at a time or as whole waves.
+// Patrol waves are created as ScriptedEnemy entities and reported through
+// 'scripted' so the caller can start their behaviours.
 class EnemyManager {
 public:
-    std::vector<EnemySpaceship> enemySpaceships;
-    void createRandomEnemySpaceship();
-    float getRandomFloat(float min, float max);
-    void generateRandomCoordinates(float& x, float& y);
-    float generateRandomVelocity(float minVelocity, float maxVelocity);
-    void update();
-    bool checkCollision(const Spacecraft& playerSpaceship);
-    void handleBoundary(EnemySpaceship& enemy);
+    std::vector<WaveDescription> waves;
+
+    void createRandomEnemySpaceship(World& world);
+    void spawnWave(World& world, const WaveDescription& wave, std::vector<ScriptedSpawn>* scripted = nullptr);
+    void spawnNextWave(World& world, std::vector<ScriptedSpawn>* scripted = nullptr);
+    bool loadWaves(std::istream& in, std::string& error);
+    void setSeed(uint32_t seed) { random.setSeed(seed); }
+
+    // Area enemies spawn in, centered on the origin (default: the normal world)
+    void setBounds(float halfWidth, float halfHeight) { boundsHalfWidth = halfWidth; boundsHalfHeight = halfHeight; }
+
+private:
+    size_t nextWave = 0;
+    float boundsHalfWidth = GameSettings::WORLD_WIDTH / 2;
+    float boundsHalfHeight = GameSettings::WORLD_HEIGHT / 2;
+    Random random;
+    std::vector<SimulationReal> randomBuffer; // Scratch space reused by spawnWave
 };
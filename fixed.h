@@ -0,0 +1,148 @@
+#pragma once
+#include <array>
+#include <cassert>
+#include <compare>
+#include <concepts>
+#include <cstdint>
+
+// Q16.16 fixed-point number for the deterministic simulation build. All
+// arithmetic is integer arithmetic, so a given sequence of operations gives
+// the same bits with every compiler, flag set and instruction set.
+// Conversions from float are exact for the constants the game uses as long as
+// they fit the 1/65536 grid, and otherwise round toward zero the same way everywhere.
+class Fixed {
+public:
+    static constexpr int FRACTION_BITS = 16;
+    static constexpr int32_t ONE = 1 << FRACTION_BITS;
+
+    constexpr Fixed() = default;
+    constexpr explicit Fixed(float value) : raw(static_cast<int32_t>(value * ONE)) {}
+    constexpr explicit Fixed(double value) : raw(static_cast<int32_t>(value * ONE)) {}
+    // Integers must fit the 16 integral bits, [-32768, 32767]
+    template <std::integral T>
+    constexpr explicit Fixed(T value) : raw(static_cast<int32_t>(static_cast<int64_t>(value) * ONE)) {
+        assert(static_cast<int64_t>(value) >= INT32_MIN / ONE && static_cast<int64_t>(value) <= INT32_MAX / ONE);
+    }
+
+    static constexpr Fixed fromRaw(int32_t raw) {
+        Fixed value;
+        value.raw = raw;
+        return value;
+    }
+
+    constexpr int32_t rawValue() const { return raw; }
+    constexpr explicit operator float() const { return static_cast<float>(raw) / ONE; }
+
+    constexpr Fixed operator-() const { return fromRaw(-raw); }
+    constexpr Fixed operator+(Fixed other) const { return fromRaw(raw + other.raw); }
+    constexpr Fixed operator-(Fixed other) const { return fromRaw(raw - other.raw); }
+    constexpr Fixed operator*(Fixed other) const {
+        return fromRaw(static_cast<int32_t>((static_cast<int64_t>(raw) * other.raw) >> FRACTION_BITS));
+    }
+    // Division by zero is a bug in the caller, checked in debug builds only
+    constexpr Fixed operator/(Fixed other) const {
+        assert(other.raw != 0);
+        return fromRaw(static_cast<int32_t>((static_cast<int64_t>(raw) * ONE) / other.raw));
+    }
+
+    constexpr Fixed& operator+=(Fixed other) { return *this = *this + other; }
+    constexpr Fixed& operator-=(Fixed other) { return *this = *this - other; }
+    constexpr Fixed& operator*=(Fixed other) { return *this = *this * other; }
+    constexpr Fixed& operator/=(Fixed other) { return *this = *this / other; }
+
+    constexpr auto operator<=>(const Fixed&) const = default;
+
+private:
+    int32_t raw = 0;
+};
+
+namespace FixedTrig {
+    constexpr int TABLE_BITS = 12;
+    constexpr int TABLE_SIZE = 1 << TABLE_BITS;     // Entries per full turn
+
+    // sin(i * 2pi / TABLE_SIZE) in Q16.16, built with a Q30 Taylor series in
+    // integer arithmetic only, so the table is the same on every compiler
+    constexpr std::array<int32_t, TABLE_SIZE + 1> buildSineTable() {
+        constexpr int64_t PI_Q30 = 3373259426;      // pi * 2^30
+        constexpr int QUARTER = TABLE_SIZE / 4;
+
+        std::array<int32_t, QUARTER + 1> quarter{};
+        for (int i = 0; i <= QUARTER; ++i) {
+            int64_t x = PI_Q30 * i / (2 * QUARTER);  // [0, pi/2] in Q30
+            int64_t x2 = (x * x) >> 30;
+            int64_t term = x;
+            int64_t sum = x;
+            for (int k = 1; k <= 8; ++k) {
+                term = -((term * x2) >> 30) / ((2 * k) * (2 * k + 1));
+                sum += term;
+            }
+            quarter[i] = static_cast<int32_t>((sum + (1 << 13)) >> 14); // Q30 -> Q16, rounded
+        }
+
+        std::array<int32_t, TABLE_SIZE + 1> table{};
+        for (int i = 0; i <= TABLE_SIZE; ++i) {
+            int index = i % TABLE_SIZE;
+            int offset = index % (2 * QUARTER);
+            int32_t value = offset <= QUARTER ? quarter[offset] : quarter[2 * QUARTER - offset];
+            table[i] = index < 2 * QUARTER ? value : -value;
+        }
+        return table;
+    }
+
+    inline constexpr std::array<int32_t, TABLE_SIZE + 1> SINE = buildSineTable();
+
+    // TABLE_SIZE / 2pi in Q16.16
+    constexpr int64_t RADIANS_TO_INDEX = 42722830;
+}
+
+// Table lookup with linear interpolation between neighbouring entries
+constexpr Fixed sin(Fixed angle) {
+    using namespace FixedTrig;
+    int64_t position = static_cast<int64_t>(angle.rawValue()) * RADIANS_TO_INDEX; // Table index in Q32
+    int index = static_cast<int>((position >> 32) & (TABLE_SIZE - 1));
+    int64_t fraction = (position >> 16) & 0xFFFF;
+    int64_t a = SINE[index];
+    int64_t b = SINE[index + 1];
+    return Fixed::fromRaw(static_cast<int32_t>(a + (((b - a) * fraction) >> 16)));
+}
+
+constexpr Fixed cos(Fixed angle) {
+    // cos(x) = sin(x + pi/2)
+    return sin(angle + Fixed::fromRaw(102944));
+}
+
+constexpr Fixed abs(Fixed value) {
+    return value < Fixed() ? -value : value;
+}
+
+constexpr Fixed floor(Fixed value) {
+    return Fixed::fromRaw(value.rawValue() & ~(Fixed::ONE - 1));
+}
+
+constexpr Fixed ceil(Fixed value) {
+    return floor(Fixed::fromRaw(value.rawValue() + Fixed::ONE - 1));
+}
+
+// Integer square root of the Q32 value, bit by bit
+constexpr Fixed sqrt(Fixed value) {
+    if (value.rawValue() <= 0) {
+        return Fixed();
+    }
+    uint64_t remainder = static_cast<uint64_t>(value.rawValue()) << Fixed::FRACTION_BITS;
+    uint64_t root = 0;
+    uint64_t bit = uint64_t(1) << 62;
+    while (bit > remainder) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (remainder >= root + bit) {
+            remainder -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return Fixed::fromRaw(static_cast<int32_t>(root));
+}
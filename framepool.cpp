@@ -0,0 +1,79 @@
+#include "framepool.h"
+#include <new>
+
+thread_local FramePool* FramePool::current = nullptr;
+
+namespace {
+    // Prepended to every frame: owning pool (null for heap frames) and size class
+    struct alignas(std::max_align_t) BlockHeader {
+        FramePool* pool;
+        size_t sizeClass;
+    };
+}
+
+FramePool::Scope::Scope(FramePool& pool) : previous(FramePool::current) {
+    FramePool::current = &pool;
+}
+
+FramePool::Scope::~Scope() {
+    FramePool::current = previous;
+}
+
+FramePool::~FramePool() {
+    for (unsigned char* slab : slabs) {
+        ::operator delete(slab);
+    }
+}
+
+void* FramePool::allocate(size_t size) {
+    size_t total = size + sizeof(BlockHeader);
+    size_t sizeClass = (total + CLASS_BYTES - 1) / CLASS_BYTES - 1;
+
+    BlockHeader* header;
+    if (current && sizeClass < CLASS_COUNT) {
+        header = static_cast<BlockHeader*>(current->allocateBlock(sizeClass));
+        header->pool = current;
+    }
+    else {
+        header = static_cast<BlockHeader*>(::operator new(total));
+        header->pool = nullptr;
+    }
+    header->sizeClass = sizeClass;
+    return header + 1;
+}
+
+void FramePool::deallocate(void* frame) {
+    BlockHeader* header = static_cast<BlockHeader*>(frame) - 1;
+    if (header->pool) {
+        header->pool->freeBlock(header, header->sizeClass);
+    }
+    else {
+        ::operator delete(header);
+    }
+}
+
+void* FramePool::allocateBlock(size_t sizeClass) {
+    ++live;
+    if (FreeBlock* block = freeLists[sizeClass]) {
+        freeLists[sizeClass] = block->next;
+        return block;
+    }
+
+    size_t bytes = (sizeClass + 1) * CLASS_BYTES;
+    if (slabRemaining < bytes) {
+        slabCursor = static_cast<unsigned char*>(::operator new(SLAB_BYTES));
+        slabs.push_back(slabCursor);
+        slabRemaining = SLAB_BYTES;
+    }
+    void* block = slabCursor;
+    slabCursor += bytes;
+    slabRemaining -= bytes;
+    return block;
+}
+
+void FramePool::freeBlock(void* block, size_t sizeClass) {
+    --live;
+    FreeBlock* freed = static_cast<FreeBlock*>(block);
+    freed->next = freeLists[sizeClass];
+    freeLists[sizeClass] = freed;
+}
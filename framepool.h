@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Free-list allocator for coroutine frames. Frames are grouped in 64 byte
+// size classes carved from slabs, so once warmed up creating and destroying
+// behaviours never touches the heap. Not thread-safe: one pool per scheduler,
+// used from the thread that runs that scheduler.
+class FramePool {
+public:
+    FramePool() = default;
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+    ~FramePool();
+
+    // Allocation entry points used by Behaviour::promise_type. They allocate
+    // from the pool made current with Scope, or from the heap if there is none.
+    // Every block remembers its pool, so it can be freed from anywhere.
+    static void* allocate(size_t size);
+    static void deallocate(void* frame);
+
+    // Makes a pool current for the frames created on this thread within the scope
+    class Scope {
+    public:
+        explicit Scope(FramePool& pool);
+        ~Scope();
+    private:
+        FramePool* previous;
+    };
+
+    size_t slabBytes() const { return slabs.size() * SLAB_BYTES; }
+    size_t liveFrames() const { return live; }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    static constexpr size_t CLASS_BYTES = 64;
+    static constexpr size_t CLASS_COUNT = 16;   // Pooled frames up to 1 KiB
+    static constexpr size_t SLAB_BYTES = 64 * 1024;
+
+    void* allocateBlock(size_t sizeClass);
+    void freeBlock(void* block, size_t sizeClass);
+
+    FreeBlock* freeLists[CLASS_COUNT] = {};
+    std::vector<unsigned char*> slabs;
+    unsigned char* slabCursor = nullptr;
+    size_t slabRemaining = 0;
+    size_t live = 0;
+
+    static thread_local FramePool* current;
+};
@@ -1,101 +1,224 @@
 #include "game.h"
 #include "settings.h"
-#include "explosion.h"
+#include "texture.h"
+#include <QFile>
 #include <QTimer>
 #include <QPainter>
 #include <QFontDatabase>
+#include <QCoreApplication>
+#include <algorithm>
+#include <cmath>
 
-game::game(QWidget *parent) : QMainWindow(parent)
+game::game(QWidget *parent, bool stressMode, float stressBudgetMs, const QString& telemetryName) : QMainWindow(parent)
 {
-    auto* gameWidget = new GameWidget(this);
+    gameWidget = new GameWidget(this, telemetryName);
     setCentralWidget(gameWidget);
 
+    if (stressMode) {
+        gameWidget->startStressMode(stressBudgetMs);
+    }
+
     // Set the size of the MainWindow
     resize(800, 600);
 }
 
 game::~game() {}
 
-GameWidget::GameWidget(QWidget* parent) : QOpenGLWidget(parent) 
+GameWidget::GameWidget(QWidget* parent, const QString& telemetryName) : QOpenGLWidget(parent)
 {
     setFocusPolicy(Qt::StrongFocus);
     setAttribute(Qt::WA_AcceptTouchEvents);
     setAttribute(Qt::WA_KeyCompression, false);
 
-    spaceshipX = 0.0f; // Initial spaceship position
-    spaceshipY = 0.0f;
-    backgroundX = 0.0f;
-    backgroundY = 0.0f;
-    cameraX = 0.0f;
-    cameraY = 0.0f;
-    spaceshipDirection = GameSettings::Direction::Right;
     spaceshipAspectRatio = 0.0f;
-    backgroundScrollSpeed = 0.0f;
     backgroundWidth = 0;
     backgroundHeight = 0;
-    moveSpeedX = moveSpeedY = 0.0f;
 
-    // Create a timer for updating the game at approximately 60fps
-    QTimer* timer = new QTimer(this);
-    connect(timer, &QTimer::timeout, this, &GameWidget::updateGame);
+    QFile waveFile(":/game/waves.txt");
+    if (waveFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        std::string error;
+        if (!simulation.loadWaves(waveFile.readAll().toStdString(), error)) {
+            qDebug() << "Bad wave table:" << QString::fromStdString(error);
+        }
+    }
+    else {
+        qDebug() << "Failed to load wave table";
+    }
+
+    // Opened before the simulation thread starts recording
+    std::string segment = telemetryName.isEmpty() ? Telemetry::defaultName() : telemetryName.toStdString();
+    if (simulation.getTelemetry().open(segment)) {
+        qInfo() << "Telemetry:" << QString::fromStdString(segment);
+    }
+    else {
+        qDebug() << "Failed to open telemetry segment" << QString::fromStdString(segment);
+    }
+
+    // The simulation runs on its own thread (started in initializeGL); this
+    // timer only checks at approximately 60fps for new snapshots to render
+    timer = new QTimer(this);
+    connect(timer, &QTimer::timeout, this, &GameWidget::pollSimulation);
     timer->start(GameSettings::FRAME_TIME); 
 }
 
 GameWidget::~GameWidget() {
 
-    for (auto* texture : Explosion::explosionTextures) {
-        delete texture;
+    simulation.stop();
+
+    // Textures must be destroyed with the context current
+    makeCurrent();
+    enemyTexture.reset();
+    bulletTexture.reset();
+    spaceshipTexture.reset();
+    backgroundTexture.reset();
+    background.reset();
+    explosionTextures.clear();
+    doneCurrent();
+}
+
+// Starts ramping the enemy count. Every STRESS_SETTLE_FRAMES frames the average
+// frame time (simulation + render) is compared with the budget; while it fits,
+// another wave of enemies is added.
+void GameWidget::startStressMode(float frameBudgetMs) {
+    stressMode = true;
+    stressBudgetMs = frameBudgetMs;
+    stressFrameTimeSum = 0.0;
+    stressFrames = 0;
+    stressSustainableEnemies = 0;
+    qInfo() << "Stress mode: frame budget" << stressBudgetMs << "ms";
+
+    // Start with one wave so the scene keeps changing and snapshots keep coming
+    InputEvent wave{ InputAction::SpawnWave };
+    wave.count = GameSettings::STRESS_WAVE_SIZE;
+    simulation.postInput(wave);
+}
+
+void GameWidget::updateStressMode(double frameTimeMs, size_t enemyCount) {
+    stressFrameTimeSum += frameTimeMs;
+    if (++stressFrames < GameSettings::STRESS_SETTLE_FRAMES) {
+        return;
+    }
+
+    double averageMs = stressFrameTimeSum / stressFrames;
+    stressFrameTimeSum = 0.0;
+    stressFrames = 0;
+
+    if (averageMs > stressBudgetMs) {
+        qInfo() << "Stress mode: average frame time" << averageMs << "ms with" << enemyCount << "enemies exceeds budget";
+        qInfo() << "Stress mode: maximum sustainable enemy count:" << stressSustainableEnemies;
+        qInfo() << "Stress mode: last frame submitted" << renderStats.submitted << "sprites, culled" << renderStats.culled;
+        qInfo() << "Stress mode: snapshots published" << simulation.snapshots().published()
+                << "missed" << simulation.snapshots().missed() << "stale" << simulation.snapshots().stale();
+        stressMode = false;
+        QCoreApplication::exit(0);
+        return;
     }
-    Explosion::explosionTextures.clear();
+
+    stressSustainableEnemies = enemyCount;
+    qInfo() << "Stress mode:" << enemyCount << "enemies, average frame time" << averageMs << "ms";
+
+    // Grow by at least a wave, or 10% once the population is large
+    InputEvent wave{ InputAction::SpawnWave };
+    wave.count = std::max(GameSettings::STRESS_WAVE_SIZE, static_cast<int>(enemyCount / 10));
+    simulation.postInput(wave);
 }
 
-void GameWidget::drawBackground() {
-    backgroundTexture->bind();
+void GameWidget::setFinishFrames(bool finish) {
+    finishFrames = finish;
+    if (background) {
+        background->setFinishTiming(finish);
+    }
+}
+
+// Nebula, stars and debris in one full-screen pass, see BackgroundRenderer
+void GameWidget::drawBackground(const RenderSnapshot& snapshot) {
+    if (!background || !backgroundTexture) {
+        return;
+    }
+    float aspectRatio = height() > 0 ? static_cast<float>(width()) / height() : 1.0f;
+    background->draw(*backgroundTexture, snapshot.cameraX, snapshot.cameraY, aspectRatio);
 
-     // Calculate texture offset for repeating background
-    float backgroundOffsetX = cameraX * GameSettings::SCROLL_FACTOR_X;
-    float backgroundOffsetY = cameraY * GameSettings::SCROLL_FACTOR_Y;
+    uint64_t gpuTimeNs;
+    if (background->takeGpuTime(gpuTimeNs)) {
+        simulation.getTelemetry().record(TelemetryHistogram::BackgroundGpuTime, gpuTimeNs / 1000);
+    }
+}
 
-    // Repeat the texture
-    glBegin(GL_QUADS);
-        glTexCoord2f(backgroundOffsetX, backgroundOffsetY); glVertex2f(-GameSettings::BACKGROUND_SCALE_X, -GameSettings::BACKGROUND_SCALE_Y);
-        glTexCoord2f(backgroundOffsetX + GameSettings::BACKGROUND_SCALE_X, backgroundOffsetY); glVertex2f(GameSettings::BACKGROUND_SCALE_X, -GameSettings::BACKGROUND_SCALE_Y);
-        glTexCoord2f(backgroundOffsetX + GameSettings::BACKGROUND_SCALE_X, backgroundOffsetY + GameSettings::BACKGROUND_SCALE_Y); glVertex2f(GameSettings::BACKGROUND_SCALE_X, GameSettings::BACKGROUND_SCALE_Y);
-        glTexCoord2f(backgroundOffsetX, backgroundOffsetY + GameSettings::BACKGROUND_SCALE_Y); glVertex2f(-GameSettings::BACKGROUND_SCALE_X, GameSettings::BACKGROUND_SCALE_Y);
-    glEnd();
+// World area seen by the camera, grown by the cull margin so sprites
+// straddling the edge are still drawn
+GameSettings::Rect GameWidget::visibleWorldArea(const RenderSnapshot& snapshot) const {
+    float halfWidth = GameSettings::VIEW_HALF_WIDTH + GameSettings::CULL_MARGIN;
+    float halfHeight = GameSettings::VIEW_HALF_HEIGHT + GameSettings::CULL_MARGIN;
+    return GameSettings::Rect(-snapshot.cameraX - halfWidth, -snapshot.cameraY - halfHeight, 2 * halfWidth, 2 * halfHeight);
+}
 
-    backgroundTexture->release();
+static bool isInside(const GameSettings::Rect& area, float x, float y) {
+    return x >= area.x && x <= area.x + area.width && y >= area.y && y <= area.y + area.height;
 }
 
-void GameWidget::drawEnemies() {
-    // Render enemy spaceships
-    enemyTexture->bind();
-    float halfEnemyshipWidth = GameSettings::ENEMY_SIZE / 2; 
-    float halfEnemyshipHeight = halfEnemyshipWidth / enemyAspectRatio;
+// Draws the visible instances of one sprite kind. The sprite frame selects the
+// texture, sprites with a single texture always use it.
+void GameWidget::drawSprites(SpriteId id, const RenderSnapshot& snapshot, const GameSettings::Rect& visibleArea) {
+    const size_t index = static_cast<size_t>(id);
+    const auto& sprites = snapshot.sprites[index];
+    const auto& frames = spriteFrames[index];
+    if (frames.empty()) {
+        renderStats.culled += sprites.size();
+        return;
+    }
+
+    visibleIndices.clear();
+    snapshot.grids[index].query(visibleArea, visibleIndices);
+
+    float halfWidth = spriteHalfWidth[index];
+    float halfHeight = spriteHalfHeight[index];
+    int lastFrame = static_cast<int>(frames.size()) - 1;
+    QOpenGLTexture* boundTexture = nullptr;
+
+    size_t submitted = 0;
+    for (uint32_t visible : visibleIndices) {
+        const auto& sprite = sprites[visible];
+        if (!isInside(visibleArea, sprite.x, sprite.y)) {
+            continue;
+        }
+        ++submitted;
+
+        QOpenGLTexture* texture = frames[std::clamp(sprite.frame, 0, lastFrame)];
+        if (texture != boundTexture) {
+            if (boundTexture) {
+                boundTexture->release();
+            }
+            texture->bind();
+            boundTexture = texture;
+        }
 
-    for (const auto& enemy : enemyManager.enemySpaceships) {
         glPushMatrix(); // save current matrix
-        glTranslatef(enemy.x, enemy.y, 0.0f);
+        glTranslatef(sprite.x, sprite.y, 0.0f);
         glBegin(GL_QUADS); 
-            glTexCoord2f(0.0f, 0.0f); glVertex2f(-halfEnemyshipWidth, -halfEnemyshipHeight);    // Bottom-left corner
-            glTexCoord2f(1.0f, 0.0f); glVertex2f(halfEnemyshipWidth, -halfEnemyshipHeight);     // Bottom-right corner
-            glTexCoord2f(1.0f, 1.0f); glVertex2f(halfEnemyshipWidth, halfEnemyshipHeight);      // Top-right corner
-            glTexCoord2f(0.0f, 1.0f); glVertex2f(-halfEnemyshipWidth, halfEnemyshipHeight);     // Top-left corner
+            glTexCoord2f(0.0f, 0.0f); glVertex2f(-halfWidth, -halfHeight);    // Bottom-left corner
+            glTexCoord2f(1.0f, 0.0f); glVertex2f(halfWidth, -halfHeight);     // Bottom-right corner
+            glTexCoord2f(1.0f, 1.0f); glVertex2f(halfWidth, halfHeight);      // Top-right corner
+            glTexCoord2f(0.0f, 1.0f); glVertex2f(-halfWidth, halfHeight);     // Top-left corner
         glEnd(); 
-        glPopMatrix(); // restor previous matrix
+        glPopMatrix(); // restore previous matrix
     }
-    enemyTexture->release();
+    if (boundTexture) {
+        boundTexture->release();
+    }
+
+    renderStats.submitted += submitted;
+    renderStats.culled += sprites.size() - submitted;
 }
 
-void GameWidget::drawPlayerSpaceship() {
+void GameWidget::drawPlayerSpaceship(const RenderSnapshot& snapshot) {
     // Draw spaceship
     spaceshipTexture->bind();
     float halfSpaceshipWidth = GameSettings::SPACESHIP_SIZE / 2;
     float halfSpaceshipHeight = halfSpaceshipWidth / spaceshipAspectRatio;
 
     glPushMatrix();
-    glTranslatef(spaceshipX, spaceshipY, 0.0f);
-    if (spaceshipDirection == GameSettings::Direction::Right) {
+    glTranslatef(snapshot.spaceshipX, snapshot.spaceshipY, 0.0f);
+    if (snapshot.spaceshipDirection == GameSettings::Direction::Right) {
         glRotatef(180.0f, 0.0f, 1.0f, 0.0f); // Rotate 180 degrees to face right
     }
 
@@ -111,30 +234,6 @@ void GameWidget::drawPlayerSpaceship() {
     spaceshipTexture->release();
 }
 
-void GameWidget::drawBullets() {
-    // Render bullets
-    bulletTexture->bind();
-    for (const auto& bullet : bullets) {
-        // Save current transformation state
-        glPushMatrix();
-
-        glTranslatef(bullet.x, bullet.y, 0.0f);
-        float halfBulletWidth = GameSettings::BULLET_SIZE / 2;
-        float halfBulletHeight = halfBulletWidth; // Adjust based on the texture aspect ratio
-
-        glBegin(GL_QUADS); // Begin defining a quadrilateral
-            glTexCoord2f(0.0f, 0.0f); glVertex2f(-halfBulletWidth, -halfBulletHeight);
-            glTexCoord2f(1.0f, 0.0f); glVertex2f(halfBulletWidth, -halfBulletHeight);
-            glTexCoord2f(1.0f, 1.0f); glVertex2f(halfBulletWidth, halfBulletHeight);
-            glTexCoord2f(0.0f, 1.0f); glVertex2f(-halfBulletWidth, halfBulletHeight);
-        glEnd(); // End the definition and render the textured quadrilateral
-
-        // Remove the top matrix from the current matrix stack
-        glPopMatrix();
-    }
-    bulletTexture->release();
-}
-
 // Initializes OpenGL settings.
 // Enables 2D texturing.
 // Sets the clear color(background color of the window).
@@ -152,10 +251,8 @@ void GameWidget::initializeGL() {
         qDebug() << "Failed to load enemy image";
     }
     enemyAspectRatio = static_cast<float>(enemyImage.width()) / static_cast<float>(enemyImage.height());
-    enemyTexture = std::make_unique<QOpenGLTexture>(enemyImage.mirrored());
-    enemyTexture->setMinificationFilter(QOpenGLTexture::Nearest);
-    enemyTexture->setMagnificationFilter(QOpenGLTexture::Linear);
-    enemyTexture->setWrapMode(QOpenGLTexture::Repeat);
+    enemyTexture = createMipmappedTexture(enemyImage.mirrored());
+    reportTextureMemory("enemy", *enemyTexture);
 
     // Load the Background Texture
     QImage backgroundImage(":/game/background.png");
@@ -166,11 +263,11 @@ void GameWidget::initializeGL() {
     backgroundWidth = backgroundImage.width();
     backgroundHeight = backgroundImage.height();
 
-    backgroundTexture = std::make_unique<QOpenGLTexture>(backgroundImage.mirrored());
-    backgroundTexture->setWrapMode(QOpenGLTexture::Repeat);
-    backgroundTexture->setMinificationFilter(QOpenGLTexture::Nearest);
-    backgroundTexture->setMagnificationFilter(QOpenGLTexture::Linear);
-    backgroundTexture->setWrapMode(QOpenGLTexture::Repeat);
+    // Keep the full resolution image, resizeGL uploads the level matching the viewport
+    backgroundSource = backgroundImage.mirrored();
+    updateBackgroundLevelOfDetail(width(), height());
+    background = std::make_unique<BackgroundRenderer>();
+    background->setFinishTiming(finishFrames);
 
     // Spacecraft
     QImage spaceshipImage(":/game/spaceship.png");
@@ -178,28 +275,74 @@ void GameWidget::initializeGL() {
         qDebug() << "Failed to load spacecraft image";
     }
     spaceshipAspectRatio = static_cast<float>(spaceshipImage.width()) / static_cast<float>(spaceshipImage.height());
-    spaceshipTexture = std::make_unique<QOpenGLTexture>(spaceshipImage.mirrored(false, true));
-    spaceshipTexture->setMinificationFilter(QOpenGLTexture::Nearest);
-    spaceshipTexture->setMagnificationFilter(QOpenGLTexture::Linear);
-    spaceshipTexture->setWrapMode(QOpenGLTexture::Repeat);
+    spaceshipTexture = createMipmappedTexture(spaceshipImage.mirrored(false, true));
+    reportTextureMemory("spaceship", *spaceshipTexture);
 
     // Bullet 
     QImage bulletImage(":/game/bullet.png");
     if (bulletImage.isNull()) {
         qDebug() << "Failed to load bullet image";
     }
-    bulletTexture = std::make_unique<QOpenGLTexture>(bulletImage.mirrored());
-    bulletTexture->setMinificationFilter(QOpenGLTexture::Nearest);
-    bulletTexture->setMagnificationFilter(QOpenGLTexture::Linear);
-    bulletTexture->setWrapMode(QOpenGLTexture::Repeat);
+    bulletTexture = createMipmappedTexture(bulletImage.mirrored());
+    reportTextureMemory("bullet", *bulletTexture);
  
     // Explosion
-    Explosion::loadTextures(this); // Load explosion textures
+    for (int i = 0; i < GameSettings::EXPLOSION_FRAMES; ++i) {
+        QString texturePath = QString(":/game/explosion_frame_%1.png").arg(i);
+        QImage img(texturePath);
+        if (img.isNull()) {
+            qDebug() << "Failed to load texture:" << texturePath;
+            continue;
+        }
+        explosionTextures.push_back(createMipmappedTexture(img));
+    }
+    if (!explosionTextures.empty()) {
+        reportTextureMemory("explosion frame", *explosionTextures.front());
+    }
+
+    // Texture list and size of each sprite kind
+    auto setSprite = [this](SpriteId id, std::vector<QOpenGLTexture*> frames, float halfWidth, float halfHeight) {
+        size_t index = static_cast<size_t>(id);
+        spriteFrames[index] = std::move(frames);
+        spriteHalfWidth[index] = halfWidth;
+        spriteHalfHeight[index] = halfHeight;
+    };
+    std::vector<QOpenGLTexture*> explosionFrames;
+    for (const auto& texture : explosionTextures) {
+        explosionFrames.push_back(texture.get());
+    }
+    setSprite(SpriteId::Enemy, { enemyTexture.get() }, GameSettings::ENEMY_SIZE / 2, GameSettings::ENEMY_SIZE / 2 / enemyAspectRatio);
+    setSprite(SpriteId::Bullet, { bulletTexture.get() }, GameSettings::BULLET_SIZE / 2, GameSettings::BULLET_SIZE / 2);
+    setSprite(SpriteId::Explosion, explosionFrames, GameSettings::EXPLOSION_SIZE / 2, GameSettings::EXPLOSION_SIZE / 2);
+
+    simulation.start(enemyAspectRatio);
 }
 
 // Sets the viewport dimensions whenever the widget is resized.
 void GameWidget::resizeGL(int w, int h) {
     glViewport(0, 0, w, h);
+    updateBackgroundLevelOfDetail(w, h);
+    sceneDirty = true;
+}
+
+// The background shader samples the nebula at screen * 0.5, so one repeat of
+// the texture spans the whole viewport. Upload the smallest halving of the
+// source that still covers the viewport's pixels, and only when it changes.
+void GameWidget::updateBackgroundLevelOfDetail(int w, int h) {
+    if (backgroundSource.isNull()) {
+        return;
+    }
+
+    int targetWidth = static_cast<int>(std::ceil(w * devicePixelRatioF()));
+    int targetHeight = static_cast<int>(std::ceil(h * devicePixelRatioF()));
+    QImage level = selectLevelOfDetail(backgroundSource, targetWidth, targetHeight);
+
+    if (backgroundTexture && backgroundTexture->width() == level.width() && backgroundTexture->height() == level.height()) {
+        return;
+    }
+
+    backgroundTexture = createMipmappedTexture(level);
+    reportTextureMemory("background", *backgroundTexture);
 }
 
 void GameWidget::drawLives()
@@ -229,7 +372,7 @@ void GameWidget::drawLives()
     glEnable(GL_TEXTURE_2D);
 }
 
-void GameWidget::drawScore()
+void GameWidget::drawScore(int score)
 {
     // Enable 2D texturing
     glEnable(GL_TEXTURE_2D);
@@ -252,188 +395,123 @@ void GameWidget::drawScore()
 
 void GameWidget::paintGL() {
 
+    QElapsedTimer paintTimer;
+    paintTimer.start();
+
     // Clear the screen to the clear color
     glClear(GL_COLOR_BUFFER_BIT);
 
+    // Latest state published by the simulation thread, never waits for it
+    const RenderSnapshot& snapshot = simulation.snapshots().acquire();
+
+    // Only entities inside the camera view are submitted
+    renderStats = RenderStats();
+    GameSettings::Rect visibleArea = visibleWorldArea(snapshot);
     // Apply camera transformation
     glPushMatrix();
-    glTranslatef(cameraX, cameraY, 0.0f);
+    glTranslatef(snapshot.cameraX, snapshot.cameraY, 0.0f);
 
     // Draw the background, enemies, etc., relative to the camera
-    drawBackground();
+    drawBackground(snapshot);
 
-    drawEnemies();
+    drawSprites(SpriteId::Enemy, snapshot, visibleArea);
 
     // Player Spaceship is always at the center
-    drawPlayerSpaceship();
-    drawBullets();
+    drawPlayerSpaceship(snapshot);
+    drawSprites(SpriteId::Bullet, snapshot, visibleArea);
 
     // Render active explosions
-    for (auto& explosion : activeExplosions) {
-        explosion.render();
-    }
+    drawSprites(SpriteId::Explosion, snapshot, visibleArea);
 
     // Draw spacecraft lives
     drawLives();
 
     // Draw the player's score
-    drawScore();
+    drawScore(snapshot.score);
  
     glPopMatrix();
+
+    if (stressMode || finishFrames) {
+        glFinish(); // Include GPU time in the measurement
+    }
+    double paintTimeMs = paintTimer.nsecsElapsed() / 1.0e6;
+
+    if (stressMode && snapshot.tick != lastRenderedTick) {
+        // Simulation and rendering run in parallel, the slower one limits the frame rate
+        updateStressMode(std::max(paintTimeMs, snapshot.tickTimeMs), snapshot.spritesOf(SpriteId::Enemy).size());
+    }
+    lastRenderedTick = snapshot.tick;
+
+    Telemetry& telemetry = simulation.getTelemetry();
+    telemetry.add(TelemetryCounter::Frames);
+    telemetry.record(TelemetryHistogram::FrameTime, static_cast<uint64_t>(paintTimeMs * 1000.0));
+    emit frameRendered(paintTimeMs);
 }
 
 void GameWidget::keyPressEvent(QKeyEvent* event) {
 
     switch (event->key()) {
     case Qt::Key_Up:
-        moveSpeedY = GameSettings::ACCELERATION;
-        scroll = true;
+        simulation.postInput({ InputAction::MoveUp });
         break;
     case Qt::Key_Down:
-        moveSpeedY = -GameSettings::ACCELERATION;
-        scroll = true;
+        simulation.postInput({ InputAction::MoveDown });
         break;
     case Qt::Key_Left:
-        spaceshipDirection = GameSettings::Direction::Left;
-        moveSpeedX = -GameSettings::ACCELERATION;
-        scroll = true;
+        simulation.postInput({ InputAction::MoveLeft });
         break;
     case Qt::Key_Right:
-        spaceshipDirection = GameSettings::Direction::Right;
-        moveSpeedX = GameSettings::ACCELERATION;
-        scroll = true;
+        simulation.postInput({ InputAction::MoveRight });
         break;
     case Qt::Key_Space:
-        Bullet newBullet;
-        newBullet.x = spaceshipX; // Initial position at the spaceship
-        newBullet.y = spaceshipY;
-
-        // Set bullet speed based on spaceship direction
-        if (spaceshipDirection == GameSettings::Direction::Left) {
-            newBullet.speed = -GameSettings::BACKGROUND_SCROLL_SPEED; // Negative speed for leftward movement
-        }
-        else { // spaceshipDirection == Right
-            newBullet.speed = GameSettings::BACKGROUND_SCROLL_SPEED; // Positive speed for rightward movement
-        }
-
-        bullets.push_back(newBullet);
+        simulation.postInput({ InputAction::Fire });
         break;
     case Qt::Key_E:
-        enemyManager.createRandomEnemySpaceship();
+        simulation.postInput({ InputAction::SpawnEnemy });
+        break;
+    case Qt::Key_W:
+        simulation.postInput({ InputAction::SpawnNextWave });
+        break;
+    case Qt::Key_R:
+        simulation.postInput({ InputAction::StartRaid });
         break;
     default:
         break;
     }
-    
-    updateGame();
+
+    // Leave low-power polling right away so the response is not delayed
+    idleTicks = 0;
+    timer->setInterval(GameSettings::FRAME_TIME);
 }
 
 void GameWidget::keyReleaseEvent(QKeyEvent* event) {
     switch (event->key()) {
     case Qt::Key_Left:
     case Qt::Key_Right:
-        moveSpeedX = 0.0f;
+        simulation.postInput({ InputAction::StopHorizontal });
         break;
     case Qt::Key_Up:
     case Qt::Key_Down:
-        moveSpeedY = 0.0f;
+        simulation.postInput({ InputAction::StopVertical });
         break;
     }
-    scroll = false;
 }
 
-void GameWidget::updateGame() {
-    
-    // Is player currently moving??
-    if (scroll) {
-        spaceshipX += moveSpeedX;
-        spaceshipY += moveSpeedY;
-    }
-    else { // No? Slowly come to a stop
-        moveSpeedX *= GameSettings::MOMENTUM_DECREASE;
-        moveSpeedY *= GameSettings::MOMENTUM_DECREASE;
-        spaceshipX += moveSpeedX;
-        spaceshipY += moveSpeedY;
-    }
-
-    cameraX = -spaceshipX;
-    cameraY = -spaceshipY;
-    
-    // Limit player movement within world boundaries
-    spaceshipX = qBound(-GameSettings::WORLD_WIDTH / 2, spaceshipX, GameSettings::WORLD_WIDTH / 2);
-    spaceshipY = qBound(-GameSettings::WORLD_HEIGHT / 2, spaceshipY, GameSettings::WORLD_HEIGHT / 2);
-
-    // Update enemy spaceships, check collision
-    enemyManager.update();
-
-    // Update bullets, check boundaries, and check for collisions
-    updateBullets();
-
-    // Update active explosions
-    updateExplosions();
-
-    update(); // Schedule a repaint
-}
-
-bool GameWidget::checkCollision(const Bullet& bullet, const EnemySpaceship& enemy) {
-    float bulletWidth = GameSettings::BULLET_SIZE;
-    float bulletHeight = bulletWidth; 
-
-    float enemyshipWidth = GameSettings::SPACESHIP_SIZE;
-    float enemyshipHeight = enemyshipWidth / enemyAspectRatio;
-
-    QRectF bulletRect(bullet.x - bulletWidth / 2, bullet.y - bulletHeight / 2, bulletWidth, bulletHeight);
-    QRectF enemyRect(enemy.x - enemyshipWidth / 2, enemy.y - enemyshipHeight / 2, enemyshipWidth, enemyshipHeight);
-
-    bool collision = bulletRect.intersects(enemyRect);
-
-    return collision;
-}
-
-void GameWidget::updateBullets()
-{
-    for (auto bullet = bullets.begin(); bullet != bullets.end();) {
-        bool bulletRemoved = false;
-        bullet->x += bullet->speed;
-
-        // Check for collision with enemy spaceships
-        for (auto enemy = enemyManager.enemySpaceships.begin(); enemy != enemyManager.enemySpaceships.end() && !bulletRemoved;) {
-            if (checkCollision(*bullet, *enemy)) {
-                Explosion explosion(bullet->x, bullet->y);
-                activeExplosions.push_back(explosion);
-
-                // Remove bullet and enemy spaceship on collision
-                bullet = bullets.erase(bullet);
-                enemy = enemyManager.enemySpaceships.erase(enemy);
-                bulletRemoved = true;
-
-                // Update score
-                score += 10;
-            }
-            else {
-                ++enemy;
-            }
-        }
-
-        // Check if bullet is out of screen boundaries
-        if (!bulletRemoved && (bullet->x > GameSettings::SCREENBOUNDARY || bullet->x < -GameSettings::SCREENBOUNDARY)) {
-            bullet = bullets.erase(bullet);
-        }
-        else if (!bulletRemoved) {
-            ++bullet;
+// Schedules a repaint only if the simulation published a new snapshot (or the
+// widget itself needs one). After IDLE_TICKS_BEFORE_LOW_POWER polls without a
+// new snapshot the timer drops to IDLE_FRAME_TIME; any change restores full rate.
+void GameWidget::pollSimulation() {
+    if (simulation.snapshots().hasNew() || sceneDirty) {
+        sceneDirty = false;
+        idleTicks = 0;
+        if (timer->interval() != GameSettings::FRAME_TIME) {
+            timer->setInterval(GameSettings::FRAME_TIME);
         }
+        update(); // Schedule a repaint
+        return;
     }
-}
 
-void GameWidget::updateExplosions()
-{
-    for (auto& explosion : activeExplosions) {
-        explosion.render();
+    if (++idleTicks >= GameSettings::IDLE_TICKS_BEFORE_LOW_POWER && timer->interval() != GameSettings::IDLE_FRAME_TIME) {
+        timer->setInterval(GameSettings::IDLE_FRAME_TIME);
     }
-
-    // Remove finished explosions
-    activeExplosions.erase(
-        std::remove_if(activeExplosions.begin(), activeExplosions.end(), [](const Explosion& e) { return e.isFinished(); }), activeExplosions.end());
 }
-
-
@@ -5,26 +5,36 @@
 #include <QOpenGLFunctions>
 #include <QOpenGLTexture>
 #include <QKeyEvent>
+#include <QElapsedTimer>
+#include <QTimer>
 #include "ui_game.h"
+#include "background.h"
 #include "settings.h"
-#include "enemy.h"
-#include "explosion.h"
+#include "simulation.h"
+#include "snapshot.h"
 
-struct Bullet {
-    float x, y;
-    float speed;
+// Per-frame sprite counters of the visibility culling
+struct RenderStats {
+    size_t submitted = 0;
+    size_t culled = 0;
 };
 
+class GameWidget;
+
 class game : public QMainWindow
 {
     Q_OBJECT
 
 public:
-    game(QWidget *parent = nullptr);
+    game(QWidget *parent = nullptr, bool stressMode = false, float stressBudgetMs = GameSettings::STRESS_FRAME_BUDGET_MS,
+        const QString& telemetryName = QString());
     ~game();
 
+    GameWidget* getGameWidget() const { return gameWidget; }
+
 private:
     Ui::gameClass ui;
+    GameWidget* gameWidget = nullptr;
 };
 
 class GameWidget : public QOpenGLWidget, protected QOpenGLFunctions {
@@ -32,51 +42,74 @@ class GameWidget : public QOpenGLWidget, protected QOpenGLFunctions {
     Q_OBJECT
 
 public:
-    GameWidget(QWidget* parent = nullptr);
+    // telemetryName: shared memory segment for live telemetry, empty for Telemetry::defaultName()
+    GameWidget(QWidget* parent = nullptr, const QString& telemetryName = QString());
     ~GameWidget();
 
+    void startStressMode(float frameBudgetMs);
+    const RenderStats& getRenderStats() const { return renderStats; }
+    Simulation& getSimulation() { return simulation; }
+
+    // Waits for the GPU at the end of every frame so frameRendered reports
+    // the full frame cost (stress mode always does)
+    void setFinishFrames(bool finish);
+
+signals:
+    void frameRendered(double paintTimeMs);
+
 protected:
     void initializeGL() override;
     void resizeGL(int w, int h) override;
     void drawLives();
-    void drawScore();
+    void drawScore(int score);
     void paintGL() override;
     void keyPressEvent(QKeyEvent* event) override;
     void keyReleaseEvent(QKeyEvent* event) override;
-    void updateGame();
-    bool checkCollision(const Bullet& bullet, const EnemySpaceship& enemy);
-    void updateBullets();
-    void updateExplosions();
+    void pollSimulation();
+    void updateStressMode(double frameTimeMs, size_t enemyCount);
 
 private:
     std::unique_ptr<QOpenGLTexture> playerLifeTexture = nullptr;
     std::unique_ptr<QOpenGLTexture> spaceshipTexture = nullptr;
     std::unique_ptr<QOpenGLTexture> backgroundTexture = nullptr;
+    std::unique_ptr<BackgroundRenderer> background = nullptr;
     std::unique_ptr<QOpenGLTexture> bulletTexture = nullptr;
     std::unique_ptr<QOpenGLTexture> enemyTexture = nullptr;
-    float cameraX, cameraY; // Camera position
-    GameSettings::Direction spaceshipDirection;
-    float backgroundScrollSpeed = 0.0f;
-    float backgroundMomentumX = 0.0f;
-    float backgroundMomentumY = 0.0f;
-    float spaceshipX = 0.0f, spaceshipY = 0.0f;
-    float backgroundX = 0.0f, backgroundY = 0.0f;
+    std::vector<std::unique_ptr<QOpenGLTexture>> explosionTextures;
     float spaceshipAspectRatio = 0.0f;
     float enemyAspectRatio = 0.0f;
-    int playerLives;
 
-    std::vector<Explosion> activeExplosions;
-    std::vector<Bullet> bullets;
-    EnemyManager enemyManager;
-    bool scroll = false;
-    float moveSpeedX, moveSpeedY = 0.0f;
-    int score = 0;
+    Simulation simulation;
+    uint64_t lastRenderedTick = 0;
+
+    // Idle-aware rendering: paintGL is only scheduled when something visible changed
+    QTimer* timer = nullptr;
+    bool sceneDirty = true;     // Set by resizes and anything else outside the simulation
+    int idleTicks = 0;
+    bool finishFrames = false;
 
-    void drawBackground();
-    void drawEnemies();
-    void drawPlayerSpaceship();
-    void drawBullets();
+    void drawBackground(const RenderSnapshot& snapshot);
+    void updateBackgroundLevelOfDetail(int w, int h);
+    void drawSprites(SpriteId id, const RenderSnapshot& snapshot, const GameSettings::Rect& visibleArea);
+    void drawPlayerSpaceship(const RenderSnapshot& snapshot);
+    GameSettings::Rect visibleWorldArea(const RenderSnapshot& snapshot) const;
+
+    // Per sprite kind: texture per animation frame and size. Culling queries
+    // the snapshot's spatial index into visibleIndices.
+    std::vector<QOpenGLTexture*> spriteFrames[SPRITE_COUNT];
+    float spriteHalfWidth[SPRITE_COUNT] = {};
+    float spriteHalfHeight[SPRITE_COUNT] = {};
+    std::vector<uint32_t> visibleIndices;
+    RenderStats renderStats;
 
     int backgroundWidth;
     int backgroundHeight;
+    QImage backgroundSource; // Full resolution background, source of the uploaded level
+
+    // Stress mode: ramps the enemy count until the frame time crosses the budget
+    bool stressMode = false;
+    float stressBudgetMs = GameSettings::STRESS_FRAME_BUDGET_MS;
+    double stressFrameTimeSum = 0.0;
+    int stressFrames = 0;
+    size_t stressSustainableEnemies = 0;
 };
\ No newline at end of file
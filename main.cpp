@@ -1,10 +1,95 @@
 #include "game.h"
+#include "soak.h"
 #include <QtWidgets/QApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <cstring>
+#include <sstream>
 
 int main(int argc, char *argv[])
 {
+    // Soak runs need no display: on a headless X11/Wayland system render
+    // offscreen unless a platform was chosen. Other platforms always have one.
+#if defined(Q_OS_UNIX) && !defined(Q_OS_DARWIN)
+    const bool headless = qEnvironmentVariableIsEmpty("DISPLAY") && qEnvironmentVariableIsEmpty("WAYLAND_DISPLAY");
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--soak") == 0 && headless && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+    }
+#endif
+
     QApplication a(argc, argv);
-    game w;
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption stressOption("stress", "Ramp the enemy count until the frame budget is exceeded and report the maximum sustainable count.");
+    QCommandLineOption budgetOption("budget", "Frame budget in milliseconds for --stress.", "ms", QString::number(GameSettings::STRESS_FRAME_BUDGET_MS));
+    QCommandLineOption telemetryOption("telemetry", "Shared memory segment name for live telemetry (default: defender-telemetry-<pid>).", "name");
+    QCommandLineOption largeWorldOption("large-world", "Play in a world of many chunks where only the ones near the player are fully simulated.");
+    parser.addOption(stressOption);
+    parser.addOption(budgetOption);
+    parser.addOption(largeWorldOption);
+    QCommandLineOption soakOption("soak", "Play the soak scenarios, report and exit non-zero on regressions. Renders offscreen when there is no display.");
+    QCommandLineOption scenariosOption("scenarios", "Soak scenario file.", "file", ":/game/soak_scenarios.txt");
+    QCommandLineOption scenarioOption("scenario", "Only run the named soak scenario.", "name");
+    QCommandLineOption baselineOption("baseline", "Soak baseline to compare with.", "file");
+    QCommandLineOption writeBaselineOption("write-baseline", "Store the soak results as a new baseline.", "file");
+    QCommandLineOption toleranceOption("tolerance", "Allowed soak regression in percent.", "percent", "10");
+    parser.addOption(telemetryOption);
+    parser.addOption(soakOption);
+    parser.addOption(scenariosOption);
+    parser.addOption(scenarioOption);
+    parser.addOption(baselineOption);
+    parser.addOption(writeBaselineOption);
+    parser.addOption(toleranceOption);
+    parser.process(a);
+
+    bool budgetOk = false;
+    const float budget = parser.value(budgetOption).toFloat(&budgetOk);
+    if (!budgetOk || budget <= 0.0f) {
+        qWarning() << "--budget needs a positive number of milliseconds, not" << parser.value(budgetOption);
+        parser.showHelp(2);
+    }
+    bool toleranceOk = false;
+    const double tolerance = parser.value(toleranceOption).toDouble(&toleranceOk);
+    if (!toleranceOk || tolerance < 0.0) {
+        qWarning() << "--tolerance needs a percentage, not" << parser.value(toleranceOption);
+        parser.showHelp(2);
+    }
+
+    game w(nullptr, parser.isSet(stressOption), budget, parser.value(telemetryOption));
+    if (parser.isSet(largeWorldOption)) {
+        w.getGameWidget()->getSimulation().setLargeWorld(true); // The simulation starts once the window is shown
+    }
+
+    if (parser.isSet(soakOption)) {
+        QFile scenarioFile(parser.value(scenariosOption));
+        std::vector<SoakScenario> scenarios;
+        if (scenarioFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            std::istringstream in(scenarioFile.readAll().toStdString());
+            loadSoakScenarios(in, scenarios);
+        }
+        if (parser.isSet(scenarioOption)) {
+            std::string only = parser.value(scenarioOption).toStdString();
+            std::erase_if(scenarios, [&](const SoakScenario& scenario) { return scenario.name != only; });
+        }
+        if (scenarios.empty()) {
+            qWarning() << "No soak scenarios in" << parser.value(scenariosOption);
+            return 2;
+        }
+
+        SoakOptions options;
+        options.baselinePath = parser.value(baselineOption).toStdString();
+        options.writeBaselinePath = parser.value(writeBaselineOption).toStdString();
+        options.tolerance = tolerance / 100.0;
+
+        auto* runner = new SoakRunner(w.getGameWidget(), std::move(scenarios), options, &w);
+        w.show();
+        runner->start();
+        return a.exec();
+    }
+
     w.show();
     return a.exec();
 }
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "fixed.h"
+
+// Small xorshift32 generator. Much cheaper than rand(), has no hidden global
+// state, and a given seed gives the same sequence on every platform.
+class Random {
+public:
+    explicit Random(uint32_t seed = 0x9E3779B9u) { setSeed(seed); }
+
+    void setSeed(uint32_t seed) { state = seed != 0 ? seed : 0x9E3779B9u; }
+
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    float nextFloat(float min, float max) {
+        return min + static_cast<float>(next()) * ((max - min) / 4294967296.0f);
+    }
+
+    // Batched variant: fills count values in one tight loop
+    void fill(float* out, size_t count, float min, float max) {
+        const float scale = (max - min) / 4294967296.0f;
+        uint32_t x = state;
+        for (size_t i = 0; i < count; ++i) {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            out[i] = min + static_cast<float>(x) * scale;
+        }
+        state = x;
+    }
+
+    // Fixed-point variant, integer math only (min <= max)
+    void fill(Fixed* out, size_t count, Fixed min, Fixed max) {
+        const uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(max.rawValue()) - min.rawValue());
+        uint32_t x = state;
+        for (size_t i = 0; i < count; ++i) {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            out[i] = Fixed::fromRaw(min.rawValue() + static_cast<int32_t>((x * range) >> 32));
+        }
+        state = x;
+    }
+
+private:
+    uint32_t state;
+};
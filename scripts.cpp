@@ -0,0 +1,12 @@
+#include "scripts.h"
+#include "settings.h"
+
+Behaviour patrolScript(SimulationReal fromX, SimulationReal toX, SimulationReal y, SimulationReal speed, uint32_t startDelay) {
+    co_await waitTicks(startDelay);
+    for (;;) {
+        co_await reach(toX, y, speed);
+        co_await waitTicks(GameSettings::PATROL_PAUSE_TICKS);
+        co_await reach(fromX, y, speed);
+        co_await waitTicks(GameSettings::PATROL_PAUSE_TICKS);
+    }
+}
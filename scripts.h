@@ -0,0 +1,8 @@
+#pragma once
+#include "behaviour.h"
+
+// Enemy behaviour scripts, run by BehaviourScheduler
+
+// Waits startDelay ticks, then flies back and forth between fromX and toX at
+// height y, pausing at both ends
+Behaviour patrolScript(SimulationReal fromX, SimulationReal toX, SimulationReal y, SimulationReal speed, uint32_t startDelay);
@@ -9,6 +9,24 @@ public:
     static constexpr float SCROLL_FACTOR_X = 0.005f;
     static constexpr float SCROLL_FACTOR_Y = 0.005f;
 
+    // Procedural background layers, drawn back to front over the nebula
+    // texture in a single shader pass. scroll: 1 moves with the sprites, 0 stays put.
+    struct BackgroundLayer {
+        float scroll;
+        float cells;        // Star cells across the screen height
+        float density;      // Fraction of cells holding a star
+        float radius;       // Largest star radius, fraction of a cell (at most 0.2)
+        float red, green, blue;
+        float opacity;      // 0 adds light (stars), 1 covers what is behind (debris)
+    };
+    static constexpr int BACKGROUND_LAYER_COUNT = 3;
+    static constexpr BackgroundLayer BACKGROUND_LAYERS[BACKGROUND_LAYER_COUNT] = {
+        { 0.05f, 48.0f, 0.35f, 0.10f, 0.70f, 0.75f, 0.90f, 0.0f },  // Far stars
+        { 0.15f, 16.0f, 0.25f, 0.12f, 1.00f, 0.95f, 0.85f, 0.0f },  // Near stars
+        { 0.60f,  5.0f, 0.12f, 0.20f, 0.30f, 0.26f, 0.24f, 0.9f }   // Foreground debris
+    };
+    static constexpr int BACKGROUND_TIMER_QUERIES = 3; // GPU timings in flight, read back this many frames later
+
     static constexpr float GAME_LEFT_BOUNDARY = -1.0f;
     static constexpr float GAME_RIGHT_BOUNDARY = 1.0f;
     static constexpr float GAME_TOP_BOUNDARY = 1.0f;
@@ -19,6 +37,8 @@ public:
     static constexpr float SPACESHIP_SIZE = 0.1f;
     static constexpr float ENEMY_SIZE = 0.13F;
     static constexpr float BULLET_SIZE = 0.025f;
+    static constexpr float EXPLOSION_SIZE = 0.1f;
+    static constexpr int   EXPLOSION_FRAMES = 10;       // One animation frame per tick
     static constexpr float BULLET_SPEED = 0.05f;
     static constexpr float SPACESHIP_SPEED = 0.02f;
     static constexpr float BULLET_WIDTH = 10.0f;
@@ -29,6 +49,44 @@ public:
     static constexpr int   PLAYER_LIVES = 3;
     static constexpr int   FRAME_TIME = 16;             // 60 fps (1 second / 60 fps ~ 16.67 ms)
 
+    // Simulation thread
+    static constexpr int   INPUT_QUEUE_SIZE = 256;      // Pending input events, power of two
+    static constexpr int   MAX_CATCHUP_TICKS = 5;       // Ticks run back to back after a stall before resyncing
+
+    // Idle-aware rendering
+    static constexpr int   IDLE_FRAME_TIME = 250;       // Low-power tick rate while nothing changes (4 Hz)
+    static constexpr int   IDLE_TICKS_BEFORE_LOW_POWER = 30; // Static ticks before dropping to IDLE_FRAME_TIME
+    static constexpr float MOMENTUM_EPSILON = 0.0001f;  // Momentum below this is treated as stopped
+
+    static constexpr float STEERING_CHANCE = 0.05f;     // Per tick chance of a drifting enemy picking a new heading
+    static constexpr int   MAX_WAVE_SIZE = 10000;       // Largest enemy count of a wave table entry
+
+    // Large-world mode (--large-world): a grid of chunks, see ChunkMap
+    static constexpr int   LARGE_WORLD_CHUNKS = 32;     // Chunks per side
+    static constexpr float CHUNK_SIZE = 2.0f;           // Chunk side, as large as the normal world
+    static constexpr int   CHUNK_ACTIVE_RADIUS = 1;     // Chunks around the player's own that are fully simulated
+    static constexpr int   CHUNK_NEAR_RADIUS = 4;       // Sleeping chunks up to this far update every CHUNK_NEAR_INTERVAL ticks
+    static constexpr int   CHUNK_NEAR_INTERVAL = 4;
+    static constexpr int   CHUNK_FAR_INTERVAL = 32;     // All other sleeping chunks
+
+    // Behaviour scripts
+    static constexpr float PATROL_DISTANCE = 0.8f;      // Horizontal span flown by patrol enemies
+    static constexpr int   PATROL_PAUSE_TICKS = 30;     // Wait at each end of a patrol
+    static constexpr int   PATROL_STAGGER_TICKS = 10;   // Start delay between patrol enemies of one wave
+    static constexpr int   RAID_WAVES = 5;              // Waves spawned by a raid script
+    static constexpr int   RAID_INTERVAL_TICKS = 120;   // Ticks between raid waves
+
+    // Visibility culling
+    static constexpr float VIEW_HALF_WIDTH = 1.0f;      // Visible area around the camera (normalized device coordinates)
+    static constexpr float VIEW_HALF_HEIGHT = 1.0f;
+    static constexpr float CULL_MARGIN = 0.1f;          // Covers the largest sprite half-size
+    static constexpr float CULL_CELL_SIZE = 0.25f;      // Spatial index cell size
+
+    // Stress mode (--stress): keep adding waves until a frame no longer fits the budget
+    static constexpr float STRESS_FRAME_BUDGET_MS = 16.0f;
+    static constexpr int   STRESS_WAVE_SIZE = 100;       // Enemies added per ramp step
+    static constexpr int   STRESS_SETTLE_FRAMES = 30;    // Frames averaged per ramp step
+
     enum Direction { Left, Right, Up, Down };
 
     // Used for Collision Detection
@@ -0,0 +1,359 @@
+#include "simulation.h"
+#include "scripts.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+
+using std::abs;
+using std::floor;
+
+Simulation::Simulation() {
+}
+
+Simulation::~Simulation() {
+    stop();
+}
+
+bool Simulation::loadWaves(const std::string& text, std::string& error) {
+    std::istringstream in(text);
+    return enemyManager.loadWaves(in, error);
+}
+
+void Simulation::setLargeWorld(bool enabled) {
+    largeWorld = enabled;
+    if (enabled) {
+        chunkMap.configure(GameSettings::LARGE_WORLD_CHUNKS, GameSettings::LARGE_WORLD_CHUNKS, GameSettings::CHUNK_SIZE);
+        worldHalfWidth = chunkMap.halfWidth();
+        worldHalfHeight = chunkMap.halfHeight();
+    }
+    else {
+        chunkMap.configure(0, 0, GameSettings::CHUNK_SIZE);
+        worldHalfWidth = Real(GameSettings::WORLD_WIDTH / 2);
+        worldHalfHeight = Real(GameSettings::WORLD_HEIGHT / 2);
+    }
+    enemyManager.setBounds(static_cast<float>(worldHalfWidth), static_cast<float>(worldHalfHeight));
+}
+
+void Simulation::setSeed(uint32_t seed) {
+    random.setSeed(seed);
+    enemyManager.setSeed(seed * 0x9E3779B9u + 1); // Its own sequence, not a copy of the steering one
+}
+
+void Simulation::start(float aspectRatio) {
+    if (running.load()) {
+        return;
+    }
+    enemyAspectRatio = aspectRatio;
+    running.store(true, std::memory_order_release);
+    thread = std::thread(&Simulation::run, this);
+}
+
+void Simulation::stop() {
+    running.store(false, std::memory_order_release);
+    wakeCondition.notify_one();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+bool Simulation::postInput(const InputEvent& event) {
+    if (!inputQueue.push(event)) {
+        droppedInputCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    // Wakes the simulation early if it is in low-power mode. notify_one never
+    // waits for the simulation thread; a wakeup lost to the race with wait_until
+    // only delays the event until the next low-power tick.
+    wakeCondition.notify_one();
+    return true;
+}
+
+// Fixed-rate loop. Ticks run every FRAME_TIME ms; after IDLE_TICKS_BEFORE_LOW_POWER
+// ticks without visible change the period drops to IDLE_FRAME_TIME until input arrives.
+void Simulation::run() {
+    using Clock = std::chrono::steady_clock;
+    const auto tickPeriod = std::chrono::milliseconds(GameSettings::FRAME_TIME);
+    const auto idlePeriod = std::chrono::milliseconds(GameSettings::IDLE_FRAME_TIME);
+    auto nextTick = Clock::now();
+
+    while (running.load(std::memory_order_acquire)) {
+        bool changed = step();
+        // Waiting scripts count in ticks, so keep the full rate while any are running
+        idleTicks = changed || behaviours.active() > 0 ? 0 : idleTicks + 1;
+        bool lowPower = idleTicks >= GameSettings::IDLE_TICKS_BEFORE_LOW_POWER;
+
+        nextTick += lowPower ? idlePeriod : tickPeriod;
+
+        // After a long stall resynchronize instead of running a burst of ticks
+        auto now = Clock::now();
+        if (now - nextTick > tickPeriod * GameSettings::MAX_CATCHUP_TICKS) {
+            nextTick = now;
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        wakeCondition.wait_until(lock, nextTick, [this, lowPower] {
+            return !running.load(std::memory_order_acquire) || (lowPower && !inputQueue.empty());
+        });
+
+        // Woken early by input: restart the schedule from now
+        now = Clock::now();
+        if (now < nextTick) {
+            nextTick = now;
+        }
+    }
+}
+
+void Simulation::applyInput(const InputEvent& event) {
+    switch (event.action) {
+    case InputAction::MoveUp:
+        moveSpeedY = Real(GameSettings::ACCELERATION);
+        scroll = true;
+        break;
+    case InputAction::MoveDown:
+        moveSpeedY = -Real(GameSettings::ACCELERATION);
+        scroll = true;
+        break;
+    case InputAction::MoveLeft:
+        spaceshipDirection = GameSettings::Direction::Left;
+        moveSpeedX = -Real(GameSettings::ACCELERATION);
+        scroll = true;
+        break;
+    case InputAction::MoveRight:
+        spaceshipDirection = GameSettings::Direction::Right;
+        moveSpeedX = Real(GameSettings::ACCELERATION);
+        scroll = true;
+        break;
+    case InputAction::StopHorizontal:
+        moveSpeedX = Real();
+        scroll = false;
+        break;
+    case InputAction::StopVertical:
+        moveSpeedY = Real();
+        scroll = false;
+        break;
+    case InputAction::Fire:
+        fireBullet();
+        break;
+    case InputAction::SpawnEnemy:
+        enemyManager.createRandomEnemySpaceship(world);
+        break;
+    case InputAction::SpawnNextWave:
+        enemyManager.spawnNextWave(world, &scripted);
+        startScripts();
+        break;
+    case InputAction::Reset:
+        reset();
+        break;
+    case InputAction::StartRaid:
+        behaviours.spawn(EntityId(), [this] { return raidScript(GameSettings::RAID_WAVES, GameSettings::RAID_INTERVAL_TICKS); });
+        break;
+    case InputAction::SpawnWave: {
+        WaveDescription wave;
+        wave.count = event.count;
+        enemyManager.spawnWave(world, wave);
+        break;
+    }
+    }
+    sceneDirty = true;
+}
+
+void Simulation::reset() {
+    behaviours.clear();
+    expiries.clear();
+    world.clear();
+    scripted.clear();
+    chunkMap.clear();
+    spaceshipX = spaceshipY = Real();
+    cameraX = cameraY = Real();
+    moveSpeedX = moveSpeedY = Real();
+    spaceshipDirection = GameSettings::Direction::Right;
+    scroll = false;
+    score = 0;
+    kills = 0;
+}
+
+void Simulation::fireBullet() {
+    // Set bullet speed based on spaceship direction
+    Real speed(GameSettings::BACKGROUND_SCROLL_SPEED); // Positive speed for rightward movement
+    if (spaceshipDirection == GameSettings::Direction::Left) {
+        speed = -speed; // Negative speed for leftward movement
+    }
+
+    EntityId bullet = world.create(ArchetypeId::Bullet);
+    ArchetypeTable& bullets = world.table(ArchetypeId::Bullet);
+    size_t row = world.rowOf(bullet);
+    bullets.positionX[row] = spaceshipX; // Initial position at the spaceship
+    bullets.positionY[row] = spaceshipY;
+    bullets.velocityX[row] = speed;
+
+    // Bullets fly straight, so the tick they leave the screen is known up front.
+    // In the large world they give up at the edge of the active chunks, past it
+    // enemies are asleep and could not be hit.
+    Real edge = worldHalfWidth + Real(GameSettings::SCREENBOUNDARY - GameSettings::WORLD_WIDTH / 2);
+    Real distance = edge - (speed > Real() ? spaceshipX : -spaceshipX);
+    if (largeWorld) {
+        distance = std::min(distance, chunkMap.activeReach(spaceshipX, speed > Real()));
+    }
+    scheduleExpiry(world, expiries, bullet, static_cast<int32_t>(static_cast<float>(floor(distance / abs(speed)))) + 1);
+}
+
+void Simulation::spawnExplosion(Real x, Real y) {
+    EntityId explosion = world.create(ArchetypeId::Explosion);
+    ArchetypeTable& explosions = world.table(ArchetypeId::Explosion);
+    size_t row = world.rowOf(explosion);
+    explosions.positionX[row] = x;
+    explosions.positionY[row] = y;
+    scheduleExpiry(world, expiries, explosion, GameSettings::EXPLOSION_FRAMES);
+}
+
+// Starts a patrol for every scripted enemy spawned since the last call,
+// staggered so a wave doesn't move in lockstep
+void Simulation::startScripts() {
+    const ArchetypeTable& enemies = world.table(ArchetypeId::ScriptedEnemy);
+    for (size_t i = 0; i < scripted.size(); ++i) {
+        size_t row = world.rowOf(scripted[i].entity);
+        Real fromX = enemies.positionX[row];
+        Real toX = std::min(fromX + Real(GameSettings::PATROL_DISTANCE), worldHalfWidth);
+        uint32_t delay = static_cast<uint32_t>(i) * GameSettings::PATROL_STAGGER_TICKS;
+        behaviours.spawn(scripted[i].entity, patrolScript, fromX, toX, enemies.positionY[row], scripted[i].speed, delay);
+    }
+    scripted.clear();
+}
+
+Behaviour Simulation::raidScript(int waves, uint32_t interval) {
+    for (int i = 0; i < waves; ++i) {
+        enemyManager.spawnNextWave(world, &scripted);
+        startScripts();
+        sceneDirty = true;
+        co_await waitTicks(interval);
+    }
+}
+
+bool Simulation::step() {
+    auto tickStart = std::chrono::steady_clock::now();
+
+    InputEvent event;
+    while (inputQueue.pop(event)) {
+        applyInput(event);
+    }
+
+    // Scripts run before the systems so velocities they set apply this tick
+    behaviours.tick();
+
+    // Is player currently moving??
+    if (scroll) {
+        spaceshipX += moveSpeedX;
+        spaceshipY += moveSpeedY;
+    }
+    else { // No? Slowly come to a stop
+        moveSpeedX *= Real(GameSettings::MOMENTUM_DECREASE);
+        moveSpeedY *= Real(GameSettings::MOMENTUM_DECREASE);
+
+        // Snap to a full stop once the drift is no longer visible
+        if (abs(moveSpeedX) < Real(GameSettings::MOMENTUM_EPSILON)) {
+            moveSpeedX = Real();
+        }
+        if (abs(moveSpeedY) < Real(GameSettings::MOMENTUM_EPSILON)) {
+            moveSpeedY = Real();
+        }
+        spaceshipX += moveSpeedX;
+        spaceshipY += moveSpeedY;
+    }
+
+    cameraX = -spaceshipX;
+    cameraY = -spaceshipY;
+
+    // Limit player movement within world boundaries
+    spaceshipX = std::clamp(spaceshipX, -worldHalfWidth, worldHalfWidth);
+    spaceshipY = std::clamp(spaceshipY, -worldHalfHeight, worldHalfHeight);
+
+    bool playerMoving = moveSpeedX != Real() || moveSpeedY != Real();
+
+    // Explosions animate every tick while any are alive
+    bool effectsActive = world.count(ArchetypeId::Explosion) > 0;
+
+    // Entity systems, each one pass over the columns it needs
+    steeringSystem(world, random, scratch);
+    bool entitiesMoved = movementSystem(world);
+    confinementSystem(world, worldHalfWidth, worldHalfHeight);
+
+    expirySystem(world, expiries, scratch);
+    animationSystem(world);
+
+    // Explosions spawned here show their first frame in this tick's snapshot
+    hits.clear();
+    collisionSystem(world, expiries, Real(GameSettings::SPACESHIP_SIZE), Real(GameSettings::SPACESHIP_SIZE / enemyAspectRatio), scratch, hits);
+    for (const auto& hit : hits) {
+        spawnExplosion(hit.x, hit.y);
+        score += 10;
+        ++kills;
+        sceneDirty = true; // HUD changed
+    }
+
+    // Large world: only the chunks around the player stay in the World
+    if (largeWorld) {
+        chunkMap.update(world, spaceshipX, spaceshipY, random, tick);
+    }
+
+    ++tick;
+
+    bool changed = playerMoving || entitiesMoved || effectsActive || sceneDirty;
+    sceneDirty = false;
+    double tickTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tickStart).count();
+    if (changed && publishSnapshots) {
+        publishSnapshot(tickTimeMs);
+    }
+    recordTelemetry(hits.size(), tickTimeMs);
+    return changed;
+}
+
+void Simulation::recordTelemetry(size_t collisions, double tickTimeMs) {
+    telemetry.add(TelemetryCounter::Ticks);
+    telemetry.record(TelemetryHistogram::TickTime, static_cast<uint64_t>(tickTimeMs * 1000.0));
+    telemetry.set(TelemetryCounter::Enemies, world.count(ArchetypeId::Enemy) + world.count(ArchetypeId::ScriptedEnemy));
+    telemetry.set(TelemetryCounter::Bullets, world.count(ArchetypeId::Bullet));
+    telemetry.set(TelemetryCounter::Explosions, world.count(ArchetypeId::Explosion));
+    size_t entities = 0;
+    for (size_t i = 0; i < ARCHETYPE_COUNT; ++i) {
+        entities += world.count(static_cast<ArchetypeId>(i));
+    }
+    telemetry.add(TelemetryCounter::EntityUpdates, entities);
+    telemetry.add(TelemetryCounter::Collisions, collisions);
+    telemetry.set(TelemetryCounter::TickCollisions, collisions);
+    telemetry.set(TelemetryCounter::Score, static_cast<uint64_t>(score));
+    telemetry.set(TelemetryCounter::DroppedInputs, droppedInputs());
+    telemetry.set(TelemetryCounter::SnapshotsMissed, snapshotBuffer.missed());
+    telemetry.set(TelemetryCounter::SleepingEntities, chunkMap.sleeping());
+    telemetry.set(TelemetryCounter::OccupiedChunks, chunkMap.occupiedChunks());
+    telemetry.set(TelemetryCounter::ChunkMigrations, chunkMap.migrations());
+}
+
+void Simulation::publishSnapshot(double tickTimeMs) {
+    RenderSnapshot& snapshot = snapshotBuffer.writeBuffer();
+    snapshot.tick = tick;
+    snapshot.cameraX = static_cast<float>(cameraX);
+    snapshot.cameraY = static_cast<float>(cameraY);
+    snapshot.spaceshipX = static_cast<float>(spaceshipX);
+    snapshot.spaceshipY = static_cast<float>(spaceshipY);
+    snapshot.spaceshipDirection = spaceshipDirection;
+    snapshot.score = score;
+    snapshot.tickTimeMs = tickTimeMs;
+
+    renderExtractSystem(world, snapshot);
+
+    // Culling index, built once per snapshot so the renderer only queries it.
+    // Centered on the view, the large world is much bigger than the grid.
+    for (size_t id = 0; id < SPRITE_COUNT; ++id) {
+        const auto& sprites = snapshot.sprites[id];
+        SpatialGrid& grid = snapshot.grids[id];
+        grid.moveTo(-snapshot.cameraX - GameSettings::SCREENBOUNDARY, -snapshot.cameraY - GameSettings::SCREENBOUNDARY);
+        grid.begin(sprites.size());
+        for (uint32_t i = 0; i < sprites.size(); ++i) {
+            grid.insert(i, sprites[i].x, sprites[i].y);
+        }
+        grid.finalize();
+    }
+
+    snapshotBuffer.publish();
+}
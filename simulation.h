@@ -0,0 +1,132 @@
+#pragma once
+#include "settings.h"
+#include "ecs.h"
+#include "enemy.h"
+#include "random.h"
+#include "snapshot.h"
+#include "spscqueue.h"
+#include "telemetry.h"
+#include "systems.h"
+#include "behaviour.h"
+#include "chunks.h"
+#include "timerwheel.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Player intent, translated from Qt key events on the GUI thread
+enum class InputAction {
+    MoveUp, MoveDown, MoveLeft, MoveRight,
+    StopHorizontal, StopVertical,
+    Fire,
+    SpawnEnemy,
+    SpawnNextWave,
+    SpawnWave,      // Random wave of 'count' enemies (stress mode)
+    StartRaid,      // Timed script spawning the next waves one after another
+    Reset           // Back to an empty world and a fresh player (soak scenarios)
+};
+
+struct InputEvent {
+    InputAction action;
+    int count = 0;
+};
+
+// Game simulation running on its own thread at a fixed tick rate.
+// Input arrives through a lock-free SPSC queue from the Qt event thread and
+// every tick that changes the scene publishes a RenderSnapshot through a
+// triple buffer, so the simulation and the GL thread never block each other.
+class Simulation {
+public:
+    using Real = SimulationReal;
+
+    Simulation();
+    ~Simulation();
+
+    // Call before start(): wave table text, see EnemyManager::loadWaves
+    bool loadWaves(const std::string& text, std::string& error);
+
+    // Call before start(): LARGE_WORLD_CHUNKS^2 chunks of CHUNK_SIZE instead of
+    // the normal world, with distant enemies asleep (see ChunkMap)
+    void setLargeWorld(bool enabled);
+
+    // Call before start(): seeds enemy placement and steering
+    void setSeed(uint32_t seed);
+
+    // Headless drivers that never render can skip building snapshots
+    void setPublishSnapshots(bool publish) { publishSnapshots = publish; }
+
+    void start(float enemyAspectRatio);
+    void stop();
+
+    // Qt event thread. Returns false if the input queue is full and the event was dropped.
+    bool postInput(const InputEvent& event);
+
+    SnapshotBuffer& snapshots() { return snapshotBuffer; }
+    Telemetry& getTelemetry() { return telemetry; }
+    // Simulation thread (or before start), empty unless in large-world mode
+    const ChunkMap& chunks() const { return chunkMap; }
+
+    // Game state for headless drivers calling step() themselves (batch runner, bots)
+    const World& getWorld() const { return world; }
+    Real getSpaceshipX() const { return spaceshipX; }
+    Real getSpaceshipY() const { return spaceshipY; }
+    int getScore() const { return score; }
+    uint64_t getKills() const { return kills; }
+    uint64_t getTick() const { return tick; }
+    bool hasActiveBehaviours() const { return behaviours.active() > 0; }
+    uint64_t droppedInputs() const { return droppedInputCount.load(std::memory_order_relaxed); }
+
+    // Runs one fixed tick, returns whether anything visible changed
+    bool step();
+
+private:
+    void run();
+    void applyInput(const InputEvent& event);
+    void reset();
+    void fireBullet();
+    void spawnExplosion(Real x, Real y);
+    void startScripts();
+    Behaviour raidScript(int waves, uint32_t interval);
+    void publishSnapshot(double tickTimeMs);
+    void recordTelemetry(size_t collisions, double tickTimeMs);
+
+    // Simulation state, only touched by the simulation thread once started
+    Real cameraX{}, cameraY{}; // Camera position
+    GameSettings::Direction spaceshipDirection = GameSettings::Direction::Right;
+    Real spaceshipX{}, spaceshipY{};
+    float enemyAspectRatio = 1.0f;
+    bool scroll = false;
+    Real moveSpeedX{}, moveSpeedY{};
+    int score = 0;
+    uint64_t kills = 0;
+    uint64_t tick = 0;
+    bool sceneDirty = true; // Set by input and HUD changes
+    int idleTicks = 0;
+    bool largeWorld = false;
+    bool publishSnapshots = true;
+    Real worldHalfWidth = Real(GameSettings::WORLD_WIDTH / 2);
+    Real worldHalfHeight = Real(GameSettings::WORLD_HEIGHT / 2);
+
+    World world;
+    EnemyManager enemyManager;
+    Random random;
+    SystemScratch scratch;
+    std::vector<CollisionHit<Real>> hits;
+    TimerWheel<EntityId> expiries;      // Lifetime component timers
+    BehaviourScheduler behaviours{ world };
+    std::vector<ScriptedSpawn> scripted;
+    ChunkMap chunkMap;
+
+    SpscQueue<InputEvent, GameSettings::INPUT_QUEUE_SIZE> inputQueue;
+    std::atomic<uint64_t> droppedInputCount{ 0 };
+    SnapshotBuffer snapshotBuffer;
+    Telemetry telemetry;
+
+    std::thread thread;
+    std::atomic<bool> running{ false };
+    std::mutex wakeMutex;               // Only locked by the simulation thread
+    std::condition_variable wakeCondition;
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include "settings.h"
+#include "components.h"
+#include "spatialgrid.h"
+#include <atomic>
+#include <vector>
+#include <cstdint>
+
+struct SpriteInstance {
+    float x, y;
+    int frame;
+};
+
+// Everything the renderer needs for one frame. Written by the simulation
+// thread, immutable once published. The vectors keep their capacity between
+// reuses, so publishing does not allocate once the buffers have warmed up.
+struct RenderSnapshot {
+    uint64_t tick = 0;
+    float cameraX = 0.0f, cameraY = 0.0f;
+    float spaceshipX = 0.0f, spaceshipY = 0.0f;
+    GameSettings::Direction spaceshipDirection = GameSettings::Direction::Right;
+    int score = 0;
+    double tickTimeMs = 0.0;   // Simulation cost of the tick that produced this snapshot
+    std::vector<SpriteInstance> sprites[SPRITE_COUNT]; // Indexed by SpriteId
+    SpatialGrid grids[SPRITE_COUNT];    // Culling index over sprites, built by the simulation at publish
+
+    const std::vector<SpriteInstance>& spritesOf(SpriteId id) const { return sprites[static_cast<size_t>(id)]; }
+    const SpatialGrid& gridOf(SpriteId id) const { return grids[static_cast<size_t>(id)]; }
+};
+
+// Lock-free triple buffer: the writer always owns one buffer, the reader owns
+// another and the third is the latest published one, exchanged atomically.
+// Neither side ever waits for the other.
+class SnapshotBuffer {
+public:
+    // Writer (simulation thread): fill the returned buffer, then publish()
+    RenderSnapshot& writeBuffer() { return buffers[writeIndex]; }
+
+    void publish() {
+        uint8_t previous = latest.exchange(static_cast<uint8_t>(writeIndex | NEW_FLAG), std::memory_order_acq_rel);
+        if (previous & NEW_FLAG) {
+            missedCount.fetch_add(1, std::memory_order_relaxed); // Reader never saw the previous one
+        }
+        writeIndex = previous & INDEX_MASK;
+        publishedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Reader (GL thread): returns the newest snapshot, or the one already held
+    // if nothing new was published since the last call
+    const RenderSnapshot& acquire() {
+        if (latest.load(std::memory_order_relaxed) & NEW_FLAG) {
+            uint8_t previous = latest.exchange(readIndex, std::memory_order_acq_rel);
+            readIndex = previous & INDEX_MASK;
+        }
+        else {
+            staleCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        return buffers[readIndex];
+    }
+
+    bool hasNew() const { return (latest.load(std::memory_order_acquire) & NEW_FLAG) != 0; }
+
+    uint64_t published() const { return publishedCount.load(std::memory_order_relaxed); }
+    uint64_t missed() const { return missedCount.load(std::memory_order_relaxed); }
+    uint64_t stale() const { return staleCount.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t NEW_FLAG = 0x4;
+
+    RenderSnapshot buffers[3];
+    uint8_t writeIndex = 0;                    // Simulation thread only
+    uint8_t readIndex = 1;                     // GL thread only
+    std::atomic<uint8_t> latest{ 2 };          // Index of the latest published buffer + NEW_FLAG
+    std::atomic<uint64_t> publishedCount{ 0 };
+    std::atomic<uint64_t> missedCount{ 0 };    // Published snapshots overwritten before being read
+    std::atomic<uint64_t> staleCount{ 0 };     // Frames rendered without a new snapshot
+};
@@ -0,0 +1,361 @@
+#include "soak.h"
+#include "alloccounter.h"
+#include "game.h"
+#include "settings.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+static double peakRssMb() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize / (1024.0 * 1024.0);
+    }
+    return 0.0;
+#else
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.0 * 1024.0); // Bytes
+#else
+    return usage.ru_maxrss / 1024.0;            // KiB
+#endif
+#endif
+}
+
+static double cpuSeconds() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        return 0.0;
+    }
+    auto seconds = [](const FILETIME& time) {
+        return ((static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime) / 1.0e7;
+    };
+    return seconds(kernel) + seconds(user);
+#else
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1.0e6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1.0e6;
+#endif
+}
+
+// Value at the given fraction of the sorted samples
+static double percentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t index = static_cast<size_t>(std::ceil(fraction * sorted.size())) - 1;
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+bool loadSoakScenarios(std::istream& in, std::vector<SoakScenario>& scenarios) {
+    scenarios.clear();
+
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        std::string keyword;
+        fields >> keyword;
+        if (keyword == "scenario") {
+            SoakScenario scenario;
+            if (fields >> scenario.name) {
+                scenarios.push_back(scenario);
+            }
+            continue;
+        }
+
+        SoakPhase phase;
+        if (scenarios.empty() || !(fields >> phase.seconds)) {
+            continue; // Malformed or outside a scenario
+        }
+        fields >> phase.amount;
+        if (keyword == "ramp") {
+            phase.kind = SoakPhaseKind::Ramp;
+        }
+        else if (keyword == "fire") {
+            phase.kind = SoakPhaseKind::Fire;
+        }
+        else if (keyword == "storm") {
+            phase.kind = SoakPhaseKind::Storm;
+        }
+        else if (keyword == "idle") {
+            phase.kind = SoakPhaseKind::Idle;
+        }
+        else {
+            continue;
+        }
+        scenarios.back().phases.push_back(phase);
+    }
+
+    scenarios.erase(std::remove_if(scenarios.begin(), scenarios.end(), [](const SoakScenario& scenario) { return scenario.phases.empty(); }), scenarios.end());
+    return !scenarios.empty();
+}
+
+// Baseline metrics and which direction is a regression
+struct SoakMetric {
+    const char* name;
+    double SoakResult::* value;
+    bool higherIsBetter;
+};
+
+static const SoakMetric SOAK_METRICS[] = {
+    { "frame_p50_ms", &SoakResult::frameP50Ms, false },
+    { "frame_p95_ms", &SoakResult::frameP95Ms, false },
+    { "frame_p99_ms", &SoakResult::frameP99Ms, false },
+    { "tick_mean_ms", &SoakResult::tickMeanMs, false },
+    { "background_gpu_ms", &SoakResult::backgroundGpuMs, false },
+    { "peak_rss_mb", &SoakResult::peakRssMb, false },
+    { "allocations_per_tick", &SoakResult::allocationsPerTick, false },
+    { "entity_updates_per_s", &SoakResult::entityUpdatesPerSecond, true },
+    { "cpu_s", &SoakResult::cpuSeconds, false },
+};
+
+void writeSoakBaseline(std::ostream& out, const std::vector<SoakResult>& results) {
+    out << "# Soak baseline: <scenario> <metric> <value>\n";
+    for (const auto& result : results) {
+        for (const auto& metric : SOAK_METRICS) {
+            out << result.scenario << ' ' << metric.name << ' ' << result.*metric.value << '\n';
+        }
+    }
+}
+
+std::map<std::string, double> loadSoakBaseline(std::istream& in) {
+    std::map<std::string, double> baseline;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string scenario, metric;
+        double value;
+        if (fields >> scenario >> metric >> value) {
+            baseline[scenario + ' ' + metric] = value;
+        }
+    }
+    return baseline;
+}
+
+int compareSoakBaseline(const std::vector<SoakResult>& results, const std::map<std::string, double>& baseline, double tolerance, std::ostream& report) {
+    int regressions = 0;
+    char line[160];
+    for (const auto& result : results) {
+        for (const auto& metric : SOAK_METRICS) {
+            const double current = result.*metric.value;
+            auto entry = baseline.find(result.scenario + ' ' + metric.name);
+            if (entry == baseline.end()) {
+                std::snprintf(line, sizeof(line), "%-10s %-22s %12.3f   (no baseline)\n", result.scenario.c_str(), metric.name, current);
+                report << line;
+                continue;
+            }
+
+            const double reference = entry->second;
+            const double change = reference != 0.0 ? (current - reference) / std::abs(reference) : 0.0;
+            const bool regressed = metric.higherIsBetter ? current < reference * (1.0 - tolerance) : current > reference * (1.0 + tolerance);
+            regressions += regressed;
+
+            std::snprintf(line, sizeof(line), "%-10s %-22s %12.3f %12.3f %+7.1f%%%s\n", result.scenario.c_str(), metric.name,
+                current, reference, change * 100.0, regressed ? "  REGRESSION" : "");
+            report << line;
+        }
+    }
+    return regressions;
+}
+
+SoakRunner::SoakRunner(GameWidget* widget, std::vector<SoakScenario> scenarios, SoakOptions options, QObject* parent)
+    : QObject(parent), widget(widget), scenarios(std::move(scenarios)), options(std::move(options)) {
+    connect(&driver, &QTimer::timeout, this, &SoakRunner::drive);
+    connect(widget, &GameWidget::frameRendered, this, &SoakRunner::onFrame);
+}
+
+void SoakRunner::start() {
+    widget->setFinishFrames(true);
+    results.clear();
+    scenarioIndex = 0;
+    beginScenario();
+    driver.start(GameSettings::FRAME_TIME);
+}
+
+void SoakRunner::beginScenario() {
+    const SoakScenario& scenario = scenarios[scenarioIndex];
+    double duration = 0.0;
+    for (const auto& phase : scenario.phases) {
+        duration += phase.seconds;
+    }
+    qInfo() << "Soak scenario" << QString::fromStdString(scenario.name) << duration << "s";
+
+    Simulation& simulation = widget->getSimulation();
+    simulation.postInput({ InputAction::Reset });
+
+    const TelemetryBlock& telemetry = simulation.getTelemetry().block();
+    const auto& tickTime = telemetry.histograms[static_cast<size_t>(TelemetryHistogram::TickTime)];
+    const auto& backgroundTime = telemetry.histograms[static_cast<size_t>(TelemetryHistogram::BackgroundGpuTime)];
+    frameTimes.clear();
+    startAllocations = allocationCount();
+    startTicks = telemetry.counters[static_cast<size_t>(TelemetryCounter::Ticks)].load(std::memory_order_relaxed);
+    startEntityUpdates = telemetry.counters[static_cast<size_t>(TelemetryCounter::EntityUpdates)].load(std::memory_order_relaxed);
+    startTickTimeSum = tickTime.sum.load(std::memory_order_relaxed);
+    startTickTimeCount = tickTime.count.load(std::memory_order_relaxed);
+    startBackgroundTimeSum = backgroundTime.sum.load(std::memory_order_relaxed);
+    startBackgroundTimeCount = backgroundTime.count.load(std::memory_order_relaxed);
+    startCpuSeconds = cpuSeconds();
+    scenarioClock.start();
+
+    phaseIndex = 0;
+    beginPhase();
+}
+
+void SoakRunner::beginPhase() {
+    Simulation& simulation = widget->getSimulation();
+    const SoakPhase& phase = scenarios[scenarioIndex].phases[phaseIndex];
+    phaseActions = 0;
+    phaseClock.start();
+
+    simulation.postInput({ InputAction::StopHorizontal });
+    simulation.postInput({ InputAction::StopVertical });
+    if (phase.kind == SoakPhaseKind::Storm) {
+        InputEvent wave{ InputAction::SpawnWave };
+        wave.count = phase.amount;
+        simulation.postInput(wave);
+        sweepDirection = 0;
+    }
+}
+
+// Runs at the game's frame rate and issues whatever the current phase has
+// due by now, so the load doesn't depend on how often this is called
+void SoakRunner::drive() {
+    Simulation& simulation = widget->getSimulation();
+    const SoakPhase& phase = scenarios[scenarioIndex].phases[phaseIndex];
+    const double elapsed = phaseClock.elapsed() / 1000.0;
+
+    switch (phase.kind) {
+    case SoakPhaseKind::Ramp:
+        for (int64_t due = static_cast<int64_t>(elapsed) + 1; phaseActions < due; ++phaseActions) {
+            InputEvent wave{ InputAction::SpawnWave };
+            wave.count = phase.amount;
+            simulation.postInput(wave);
+        }
+        break;
+    case SoakPhaseKind::Fire:
+        for (int64_t due = static_cast<int64_t>(elapsed * phase.amount); phaseActions < due; ++phaseActions) {
+            simulation.postInput({ InputAction::Fire });
+        }
+        break;
+    case SoakPhaseKind::Storm: {
+        simulation.postInput({ InputAction::Fire });
+        int direction = static_cast<int64_t>(elapsed) % 2 == 0 ? 1 : -1;
+        if (direction != sweepDirection) {
+            sweepDirection = direction;
+            simulation.postInput({ direction > 0 ? InputAction::MoveUp : InputAction::MoveDown });
+        }
+        break;
+    }
+    case SoakPhaseKind::Idle:
+        break;
+    }
+
+    if (elapsed < phase.seconds) {
+        return;
+    }
+    if (++phaseIndex < scenarios[scenarioIndex].phases.size()) {
+        beginPhase();
+        return;
+    }
+
+    endScenario();
+    if (++scenarioIndex < scenarios.size()) {
+        beginScenario();
+    }
+    else {
+        finish();
+    }
+}
+
+void SoakRunner::onFrame(double paintTimeMs) {
+    frameTimes.push_back(paintTimeMs);
+}
+
+void SoakRunner::endScenario() {
+    const TelemetryBlock& telemetry = widget->getSimulation().getTelemetry().block();
+    const auto& tickTime = telemetry.histograms[static_cast<size_t>(TelemetryHistogram::TickTime)];
+    const auto& backgroundTime = telemetry.histograms[static_cast<size_t>(TelemetryHistogram::BackgroundGpuTime)];
+    const double seconds = scenarioClock.elapsed() / 1000.0;
+    const uint64_t ticks = telemetry.counters[static_cast<size_t>(TelemetryCounter::Ticks)].load(std::memory_order_relaxed) - startTicks;
+    const uint64_t entityUpdates = telemetry.counters[static_cast<size_t>(TelemetryCounter::EntityUpdates)].load(std::memory_order_relaxed) - startEntityUpdates;
+    const uint64_t tickTimeSum = tickTime.sum.load(std::memory_order_relaxed) - startTickTimeSum;
+    const uint64_t tickTimeCount = tickTime.count.load(std::memory_order_relaxed) - startTickTimeCount;
+    const uint64_t backgroundTimeSum = backgroundTime.sum.load(std::memory_order_relaxed) - startBackgroundTimeSum;
+    const uint64_t backgroundTimeCount = backgroundTime.count.load(std::memory_order_relaxed) - startBackgroundTimeCount;
+
+    std::sort(frameTimes.begin(), frameTimes.end());
+
+    SoakResult result;
+    result.scenario = scenarios[scenarioIndex].name;
+    result.frames = frameTimes.size();
+    result.frameP50Ms = percentile(frameTimes, 0.50);
+    result.frameP95Ms = percentile(frameTimes, 0.95);
+    result.frameP99Ms = percentile(frameTimes, 0.99);
+    result.frameMaxMs = frameTimes.empty() ? 0.0 : frameTimes.back();
+    result.tickMeanMs = tickTimeCount ? tickTimeSum / 1000.0 / tickTimeCount : 0.0;
+    result.backgroundGpuMs = backgroundTimeCount ? backgroundTimeSum / 1000.0 / backgroundTimeCount : 0.0;
+    result.peakRssMb = peakRssMb();
+    result.allocationsPerTick = ticks ? static_cast<double>(allocationCount() - startAllocations) / ticks : 0.0;
+    result.entityUpdatesPerSecond = seconds > 0.0 ? entityUpdates / seconds : 0.0;
+    result.cpuSeconds = cpuSeconds() - startCpuSeconds;
+    results.push_back(result);
+
+    qInfo() << "  frames" << result.frames << "p50" << result.frameP50Ms << "ms p99" << result.frameP99Ms
+        << "ms, background GPU" << result.backgroundGpuMs << "ms, peak RSS" << result.peakRssMb << "MB," << result.entityUpdatesPerSecond << "entity updates/s";
+}
+
+void SoakRunner::finish() {
+    driver.stop();
+
+    if (!options.writeBaselinePath.empty()) {
+        std::ofstream out(options.writeBaselinePath);
+        writeSoakBaseline(out, results);
+        if (!out) {
+            qWarning() << "Failed to write baseline" << QString::fromStdString(options.writeBaselinePath);
+            QCoreApplication::exit(2);
+            return;
+        }
+    }
+
+    std::map<std::string, double> baseline;
+    if (!options.baselinePath.empty()) {
+        std::ifstream in(options.baselinePath);
+        if (!in) {
+            qWarning() << "Failed to read baseline" << QString::fromStdString(options.baselinePath);
+            QCoreApplication::exit(2);
+            return;
+        }
+        baseline = loadSoakBaseline(in);
+    }
+
+    int regressions = compareSoakBaseline(results, baseline, options.tolerance, std::cout);
+    std::cout.flush();
+    if (regressions > 0) {
+        qWarning() << regressions << "metrics regressed by more than" << options.tolerance * 100.0 << "%";
+    }
+    QCoreApplication::exit(regressions > 0 ? 1 : 0);
+}
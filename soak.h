@@ -0,0 +1,111 @@
+#pragma once
+#include <QObject>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+class GameWidget;
+
+// What a soak scenario does for a while. See soak_scenarios.txt.
+enum class SoakPhaseKind {
+    Ramp,   // 'amount' more enemies every second
+    Fire,   // 'amount' shots per second
+    Storm,  // 'amount' enemies at once, then rapid fire while sweeping up and down
+    Idle    // No input at all
+};
+
+struct SoakPhase {
+    SoakPhaseKind kind = SoakPhaseKind::Idle;
+    double seconds = 0.0;
+    int amount = 0;
+};
+
+struct SoakScenario {
+    std::string name;
+    std::vector<SoakPhase> phases;
+};
+
+// Measurements of one scenario run
+struct SoakResult {
+    std::string scenario;
+    uint64_t frames = 0;
+    double frameP50Ms = 0.0;
+    double frameP95Ms = 0.0;
+    double frameP99Ms = 0.0;
+    double frameMaxMs = 0.0;
+    double tickMeanMs = 0.0;
+    double backgroundGpuMs = 0.0;       // Mean GPU time of the background pass
+    double peakRssMb = 0.0;             // Process peak so far
+    double allocationsPerTick = 0.0;
+    double entityUpdatesPerSecond = 0.0;
+    double cpuSeconds = 0.0;
+};
+
+// Scenario table, one scenario per "scenario <name>" line followed by its phases
+bool loadSoakScenarios(std::istream& in, std::vector<SoakScenario>& scenarios);
+
+// Baseline file: one "<scenario> <metric> <value>" line per measurement
+void writeSoakBaseline(std::ostream& out, const std::vector<SoakResult>& results);
+std::map<std::string, double> loadSoakBaseline(std::istream& in);
+
+// Prints every metric next to its baseline. Returns the number of metrics
+// worse than the baseline by more than 'tolerance' (0.1 = 10%).
+int compareSoakBaseline(const std::vector<SoakResult>& results, const std::map<std::string, double>& baseline, double tolerance, std::ostream& report);
+
+struct SoakOptions {
+    std::string baselinePath;       // Compare with this baseline when set
+    std::string writeBaselinePath;  // Store the results as a new baseline when set
+    double tolerance = 0.1;
+};
+
+// Plays scenarios through a live GameWidget, the real simulation thread and
+// paintGL included, then reports and exits the application: 0 when all
+// metrics are within tolerance of the baseline, 1 on regressions, 2 on errors.
+// Meant for QT_QPA_PLATFORM=offscreen with a software GL (Mesa llvmpipe).
+// The game only has a Visual Studio project, so running this on Linux needs
+// a local Qt 6 build of the same sources with game.h and soak.h through moc,
+// game.ui through uic and game.qrc through rcc.
+class SoakRunner : public QObject {
+    Q_OBJECT
+
+public:
+    SoakRunner(GameWidget* widget, std::vector<SoakScenario> scenarios, SoakOptions options, QObject* parent = nullptr);
+
+    void start();
+
+private:
+    void drive();
+    void onFrame(double paintTimeMs);
+    void beginScenario();
+    void endScenario();
+    void beginPhase();
+    void finish();
+
+    GameWidget* widget;
+    std::vector<SoakScenario> scenarios;
+    SoakOptions options;
+    std::vector<SoakResult> results;
+
+    QTimer driver;
+    QElapsedTimer scenarioClock;
+    QElapsedTimer phaseClock;
+    size_t scenarioIndex = 0;
+    size_t phaseIndex = 0;
+    int64_t phaseActions = 0;       // Waves or shots issued in the current phase
+    int sweepDirection = 0;
+
+    // Counter values at scenario start
+    std::vector<double> frameTimes;
+    uint64_t startAllocations = 0;
+    uint64_t startTicks = 0;
+    uint64_t startEntityUpdates = 0;
+    uint64_t startTickTimeSum = 0;
+    uint64_t startTickTimeCount = 0;
+    uint64_t startBackgroundTimeSum = 0;
+    uint64_t startBackgroundTimeCount = 0;
+    double startCpuSeconds = 0.0;
+};
@@ -0,0 +1,66 @@
+#include "spatialgrid.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialGrid::SpatialGrid(float minX, float minY, float width, float height, float cellSize)
+    : minX(minX), minY(minY), inverseCellSize(1.0f / cellSize) {
+    columns = std::max(1, static_cast<int>(std::ceil(width / cellSize)));
+    rows = std::max(1, static_cast<int>(std::ceil(height / cellSize)));
+    cellStart.assign(static_cast<size_t>(columns) * rows + 1, 0);
+}
+
+SpatialGrid::SpatialGrid()
+    : SpatialGrid(-GameSettings::SCREENBOUNDARY, -GameSettings::SCREENBOUNDARY,
+        2 * GameSettings::SCREENBOUNDARY, 2 * GameSettings::SCREENBOUNDARY, GameSettings::CULL_CELL_SIZE) {
+}
+
+int SpatialGrid::cellX(float x) const {
+    return std::clamp(static_cast<int>(std::floor((x - minX) * inverseCellSize)), 0, columns - 1);
+}
+
+int SpatialGrid::cellY(float y) const {
+    return std::clamp(static_cast<int>(std::floor((y - minY) * inverseCellSize)), 0, rows - 1);
+}
+
+void SpatialGrid::begin(size_t entityCount) {
+    pendingIndex.clear();
+    pendingCell.clear();
+    pendingIndex.reserve(entityCount);
+    pendingCell.reserve(entityCount);
+}
+
+void SpatialGrid::insert(uint32_t index, float x, float y) {
+    pendingIndex.push_back(index);
+    pendingCell.push_back(static_cast<uint32_t>(cellY(y) * columns + cellX(x)));
+}
+
+// Counting sort of the inserted entities by cell
+void SpatialGrid::finalize() {
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+    for (uint32_t cell : pendingCell) {
+        ++cellStart[cell + 1];
+    }
+    for (size_t i = 1; i < cellStart.size(); ++i) {
+        cellStart[i] += cellStart[i - 1];
+    }
+
+    cellEntries.resize(pendingIndex.size());
+    cursor.assign(cellStart.begin(), cellStart.end() - 1);
+    for (size_t i = 0; i < pendingIndex.size(); ++i) {
+        cellEntries[cursor[pendingCell[i]]++] = pendingIndex[i];
+    }
+}
+
+void SpatialGrid::query(const GameSettings::Rect& area, std::vector<uint32_t>& out) const {
+    int firstColumn = cellX(area.x);
+    int lastColumn = cellX(area.x + area.width);
+    int firstRow = cellY(area.y);
+    int lastRow = cellY(area.y + area.height);
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        // Cells of one row are contiguous, so the whole span is one range
+        uint32_t begin = cellStart[row * columns + firstColumn];
+        uint32_t end = cellStart[row * columns + lastColumn + 1];
+        out.insert(out.end(), cellEntries.begin() + begin, cellEntries.begin() + end);
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "settings.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Uniform grid over a fixed area, rebuilt from scratch every frame.
+// Entities are referenced by their index in the owning container; positions
+// outside the area are clamped into the border cells, so nothing is lost.
+class SpatialGrid {
+public:
+    SpatialGrid(float minX, float minY, float width, float height, float cellSize);
+    // Culling grid: two screen boundaries square, moved along with the camera
+    SpatialGrid();
+
+    // Moves the covered area, takes effect with the next begin()
+    void moveTo(float x, float y) { minX = x; minY = y; }
+
+    // Build: begin(), insert() every entity, then finalize() before querying
+    void begin(size_t entityCount);
+    void insert(uint32_t index, float x, float y);
+    void finalize();
+
+    // Appends the indices of all entities in cells overlapping the area.
+    // Candidates are per cell, callers still do the exact overlap test.
+    void query(const GameSettings::Rect& area, std::vector<uint32_t>& out) const;
+
+private:
+    int cellX(float x) const;
+    int cellY(float y) const;
+
+    float minX, minY;
+    float inverseCellSize;
+    int columns, rows;
+    std::vector<uint32_t> cellStart;     // Prefix sums, cellStart[c]..cellStart[c+1] are the entries of cell c
+    std::vector<uint32_t> cellEntries;   // Entity indices sorted by cell
+    std::vector<uint32_t> pendingIndex;  // Inserted entities waiting for finalize()
+    std::vector<uint32_t> pendingCell;
+    std::vector<uint32_t> cursor;        // finalize() scratch, reused
+};
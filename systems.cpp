@@ -0,0 +1,168 @@
+#include "systems.h"
+#include "settings.h"
+#include <algorithm>
+#include <cmath>
+
+static constexpr float PI = 3.14159265358979323846f;
+
+// float uses <cmath>, Fixed its own lookup table and integer versions
+using std::abs;
+using std::cos;
+using std::sin;
+
+template <typename Real>
+void steeringSystem(BasicWorld<Real>& world, Random& random, BasicSystemScratch<Real>& scratch) {
+    std::vector<Real>& randomBuffer = scratch.randomBuffer;
+    world.forEachTable(Component::Velocity | Component::Drift, [&](BasicArchetypeTable<Real>& table) {
+        const size_t count = table.size();
+
+        // One roll and one angle per entity, drawn as a single batch
+        randomBuffer.resize(count * 2);
+        Real* roll = randomBuffer.data();
+        Real* angle = roll + count;
+        random.fill(roll, count, Real(0), Real(1));
+        random.fill(angle, count, Real(0), Real(2.0f * PI));
+
+        const Real chance(GameSettings::STEERING_CHANCE);
+        for (size_t i = 0; i < count; ++i) {
+            if (roll[i] < chance) {
+                table.velocityX[i] = cos(angle[i]) * table.driftSpeed[i];
+                table.velocityY[i] = sin(angle[i]) * table.driftSpeed[i];
+            }
+        }
+    });
+}
+
+template <typename Real>
+bool movementSystem(BasicWorld<Real>& world) {
+    bool moving = false;
+    world.forEachTable(Component::Position | Component::Velocity, [&](BasicArchetypeTable<Real>& table) {
+        Real* x = table.positionX.data();
+        Real* y = table.positionY.data();
+        const Real* velocityX = table.velocityX.data();
+        const Real* velocityY = table.velocityY.data();
+        const size_t count = table.size();
+
+        for (size_t i = 0; i < count; ++i) {
+            x[i] += velocityX[i];
+            y[i] += velocityY[i];
+            moving |= (velocityX[i] != Real()) | (velocityY[i] != Real());
+        }
+    });
+    return moving;
+}
+
+template <typename Real>
+void confinementSystem(BasicWorld<Real>& world, Real halfWidth, Real halfHeight) {
+    world.forEachTable(Component::Position | Component::Drift, [&](BasicArchetypeTable<Real>& table) {
+        const size_t count = table.size();
+        for (size_t i = 0; i < count; ++i) {
+            table.positionX[i] = std::clamp(table.positionX[i], -halfWidth, halfWidth);
+            table.positionY[i] = std::clamp(table.positionY[i], -halfHeight, halfHeight);
+        }
+    });
+}
+
+template <typename Real>
+void collisionSystem(BasicWorld<Real>& world, TimerWheel<EntityId>& expiries, Real targetWidth, Real targetHeight, BasicSystemScratch<Real>& scratch, std::vector<CollisionHit<Real>>& hits) {
+    const Real reachX = (Real(GameSettings::BULLET_SIZE) + targetWidth) / Real(2);
+    const Real reachY = (Real(GameSettings::BULLET_SIZE) + targetHeight) / Real(2);
+
+    std::vector<EntityId>& destroyed = scratch.doomed;
+    std::vector<uint8_t>& targetHit = scratch.flags;
+    destroyed.clear();
+
+    world.forEachTable(Component::Position | Component::Target, [&](BasicArchetypeTable<Real>& targets) {
+        targetHit.assign(targets.size(), 0);
+        const Real* targetX = targets.positionX.data();
+        const Real* targetY = targets.positionY.data();
+        const size_t targetCount = targets.size();
+
+        world.forEachTable(Component::Position | Component::Projectile, [&](BasicArchetypeTable<Real>& projectiles) {
+            for (size_t p = 0; p < projectiles.size(); ++p) {
+                const Real x = projectiles.positionX[p];
+                const Real y = projectiles.positionY[p];
+
+                // Linear scan over the target position columns
+                for (size_t t = 0; t < targetCount; ++t) {
+                    if (!targetHit[t] && abs(targetX[t] - x) < reachX && abs(targetY[t] - y) < reachY) {
+                        targetHit[t] = 1;
+                        hits.push_back({ x, y });
+                        destroyed.push_back(world.entityAt(projectiles.archetype, p));
+                        destroyed.push_back(world.entityAt(targets.archetype, t));
+                        break;
+                    }
+                }
+            }
+        });
+
+        // Rows move on destroy, so only after both passes
+        for (EntityId id : destroyed) {
+            BasicArchetypeTable<Real>& table = world.table(world.archetypeOf(id));
+            if (table.has(Component::Lifetime)) {
+                expiries.cancel(table.expiry[world.rowOf(id)]);
+            }
+            world.destroy(id);
+        }
+        destroyed.clear();
+    });
+}
+
+template <typename Real>
+void scheduleExpiry(BasicWorld<Real>& world, TimerWheel<EntityId>& expiries, EntityId id, int32_t ticks) {
+    BasicArchetypeTable<Real>& table = world.table(world.archetypeOf(id));
+    size_t row = world.rowOf(id);
+    expiries.cancel(table.expiry[row]);
+    table.expiry[row] = expiries.schedule(static_cast<uint64_t>(std::max(ticks, 1) - 1), id);
+}
+
+template <typename Real>
+void expirySystem(BasicWorld<Real>& world, TimerWheel<EntityId>& expiries, BasicSystemScratch<Real>& scratch) {
+    std::vector<EntityId>& expired = scratch.doomed;
+    expired.clear();
+    expiries.advance(expired);
+
+    // Timers are cancelled when their entity dies early, destroy() still
+    // ignores anything that is already gone
+    for (EntityId id : expired) {
+        world.destroy(id);
+    }
+}
+
+template <typename Real>
+void animationSystem(BasicWorld<Real>& world) {
+    world.forEachTable(Component::Sprite | Component::Animated, [&](BasicArchetypeTable<Real>& table) {
+        for (auto& frame : table.spriteFrame) {
+            ++frame;
+        }
+    });
+}
+
+template <typename Real>
+void renderExtractSystem(const BasicWorld<Real>& world, RenderSnapshot& snapshot) {
+    for (auto& sprites : snapshot.sprites) {
+        sprites.clear();
+    }
+
+    world.forEachTable(Component::Position | Component::Sprite, [&](const BasicArchetypeTable<Real>& table) {
+        auto& sprites = snapshot.sprites[static_cast<size_t>(table.sprite)];
+        const size_t count = table.size();
+        for (size_t i = 0; i < count; ++i) {
+            sprites.push_back({ static_cast<float>(table.positionX[i]), static_cast<float>(table.positionY[i]), table.spriteFrame[i] });
+        }
+    });
+}
+
+#define INSTANTIATE_SYSTEMS(Real) \
+    template void steeringSystem(BasicWorld<Real>&, Random&, BasicSystemScratch<Real>&); \
+    template bool movementSystem(BasicWorld<Real>&); \
+    template void confinementSystem(BasicWorld<Real>&, Real, Real); \
+    template void collisionSystem(BasicWorld<Real>&, TimerWheel<EntityId>&, Real, Real, BasicSystemScratch<Real>&, std::vector<CollisionHit<Real>>&); \
+    template void scheduleExpiry(BasicWorld<Real>&, TimerWheel<EntityId>&, EntityId, int32_t); \
+    template void expirySystem(BasicWorld<Real>&, TimerWheel<EntityId>&, BasicSystemScratch<Real>&); \
+    template void animationSystem(BasicWorld<Real>&); \
+    template void renderExtractSystem(const BasicWorld<Real>&, RenderSnapshot&);
+
+INSTANTIATE_SYSTEMS(float)
+INSTANTIATE_SYSTEMS(Fixed)
+#undef INSTANTIATE_SYSTEMS
@@ -0,0 +1,59 @@
+#pragma once
+#include "ecs.h"
+#include "random.h"
+#include "snapshot.h"
+#include "timerwheel.h"
+#include <vector>
+
+// Systems are plain functions, each one linear pass over exactly the
+// component columns it needs, in every table that carries them. They are
+// templates on the World's number type and instantiated for float and Fixed
+// in systems.cpp.
+
+template <typename Real>
+struct CollisionHit {
+    Real x, y; // Where the projectile hit
+};
+
+// Buffers reused from tick to tick so the systems don't allocate once warmed up
+template <typename Real>
+struct BasicSystemScratch {
+    std::vector<Real> randomBuffer;
+    std::vector<EntityId> doomed;
+    std::vector<uint8_t> flags;
+};
+
+using SystemScratch = BasicSystemScratch<SimulationReal>;
+
+// Drift: occasionally picks a new random heading at the entity's drift speed
+template <typename Real>
+void steeringSystem(BasicWorld<Real>& world, Random& random, BasicSystemScratch<Real>& scratch);
+
+// Position += Velocity. Returns whether any entity has a non-zero velocity.
+template <typename Real>
+bool movementSystem(BasicWorld<Real>& world);
+
+// Drift: keeps drifting entities inside the world, centered on the origin
+template <typename Real>
+void confinementSystem(BasicWorld<Real>& world, Real halfWidth, Real halfHeight);
+
+// Projectile vs Target overlap. Both entities of every hit are destroyed, their
+// expiry timers cancelled and the hit positions appended to hits.
+template <typename Real>
+void collisionSystem(BasicWorld<Real>& world, TimerWheel<EntityId>& expiries, Real targetWidth, Real targetHeight, BasicSystemScratch<Real>& scratch, std::vector<CollisionHit<Real>>& hits);
+
+// Lifetime: gives the entity an expiry timer firing in 'ticks' ticks, counting the current one
+template <typename Real>
+void scheduleExpiry(BasicWorld<Real>& world, TimerWheel<EntityId>& expiries, EntityId id, int32_t ticks);
+
+// Lifetime: advances the expiry wheel and destroys the entities that are due
+template <typename Real>
+void expirySystem(BasicWorld<Real>& world, TimerWheel<EntityId>& expiries, BasicSystemScratch<Real>& scratch);
+
+// Animated: advances the sprite frame
+template <typename Real>
+void animationSystem(BasicWorld<Real>& world);
+
+// Position + Sprite: copies what the renderer needs into the snapshot, as float
+template <typename Real>
+void renderExtractSystem(const BasicWorld<Real>& world, RenderSnapshot& snapshot);
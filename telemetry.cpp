@@ -0,0 +1,249 @@
+#include "telemetry.h"
+#include <chrono>
+#include <iterator>
+#include <new>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+const char* telemetryCounterName(TelemetryCounter counter) {
+    static const char* const names[] = {
+        "ticks", "frames", "enemies", "bullets", "explosions",
+        "collisions", "tick_collisions", "score", "dropped_inputs", "snapshots_missed",
+        "entity_updates", "sleeping_entities", "occupied_chunks", "chunk_migrations"
+    };
+    static_assert(std::size(names) == static_cast<size_t>(TelemetryCounter::Count));
+    return names[static_cast<size_t>(counter)];
+}
+
+const char* telemetryHistogramName(TelemetryHistogram histogram) {
+    static const char* const names[] = { "frame_time_us", "tick_time_us", "background_gpu_us" };
+    static_assert(std::size(names) == static_cast<size_t>(TelemetryHistogram::Count));
+    return names[static_cast<size_t>(histogram)];
+}
+
+// Segment names are plain identifiers; the platform prefix is added here
+static std::string segmentPath(const std::string& name) {
+#ifdef _WIN32
+    return "Local\\" + name;
+#else
+    return "/" + name;
+#endif
+}
+
+#ifndef _WIN32
+// Whether the segment at path was left behind by a process that no longer
+// runs. A block without a complete header counts as live, its writer may
+// still be filling it.
+static bool segmentOwnerGone(const std::string& path) {
+    int fd = shm_open(path.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return errno == ENOENT;
+    }
+    struct stat status;
+    void* view = MAP_FAILED;
+    if (fstat(fd, &status) == 0 && status.st_size >= static_cast<off_t>(sizeof(TelemetryBlock))) {
+        view = mmap(nullptr, sizeof(TelemetryBlock), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        return false;
+    }
+    const TelemetryBlock* block = static_cast<const TelemetryBlock*>(view);
+    const bool gone = block->magic == TELEMETRY_MAGIC && kill(static_cast<pid_t>(block->processId), 0) != 0 && errno == ESRCH;
+    munmap(view, sizeof(TelemetryBlock));
+    return gone;
+}
+#endif
+
+Telemetry::Telemetry() {
+    initialize(privateBlock);
+}
+
+Telemetry::~Telemetry() {
+    close();
+}
+
+void Telemetry::initialize(TelemetryBlock& block) {
+    block.magic = TELEMETRY_MAGIC;
+    block.version = TELEMETRY_VERSION;
+    block.size = sizeof(TelemetryBlock);
+#ifdef _WIN32
+    block.processId = static_cast<uint32_t>(GetCurrentProcessId());
+#else
+    block.processId = static_cast<uint32_t>(getpid());
+#endif
+    block.startTimeMs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+std::string Telemetry::defaultName() {
+#ifdef _WIN32
+    return "defender-telemetry-" + std::to_string(GetCurrentProcessId());
+#else
+    return "defender-telemetry-" + std::to_string(getpid());
+#endif
+}
+
+bool Telemetry::open(const std::string& name) {
+    close();
+    const std::string path = segmentPath(name);
+
+#ifdef _WIN32
+    HANDLE handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, sizeof(TelemetryBlock), path.c_str());
+    if (!handle) {
+        return false;
+    }
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+        CloseHandle(handle);    // Another live game owns the name
+        return false;
+    }
+    void* view = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(TelemetryBlock));
+    if (!view) {
+        CloseHandle(handle);
+        return false;
+    }
+    mappingHandle = handle;
+#else
+    // Never share a block: a live game owning the name makes this fail, a
+    // segment left behind by a crashed one is replaced
+    int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0 && errno == EEXIST && segmentOwnerGone(path)) {
+        shm_unlink(path.c_str());
+        fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    }
+    if (fd < 0) {
+        return false;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+        ::close(fd);
+        shm_unlink(path.c_str());
+        return false;
+    }
+    segmentDevice = static_cast<uint64_t>(status.st_dev);
+    segmentInode = static_cast<uint64_t>(status.st_ino);
+    if (ftruncate(fd, sizeof(TelemetryBlock)) != 0) {
+        ::close(fd);
+        shm_unlink(path.c_str());
+        return false;
+    }
+    void* view = mmap(nullptr, sizeof(TelemetryBlock), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        shm_unlink(path.c_str());
+        return false;
+    }
+#endif
+
+    // Carry over what was recorded on the private block, the header goes in
+    // last so a reader doesn't accept a block that is still being filled
+    TelemetryBlock* shared = new (view) TelemetryBlock();
+    for (size_t i = 0; i < TELEMETRY_MAX_COUNTERS; ++i) {
+        shared->counters[i].store(privateBlock.counters[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    for (size_t h = 0; h < TELEMETRY_MAX_HISTOGRAMS; ++h) {
+        const TelemetryHistogramData& from = privateBlock.histograms[h];
+        TelemetryHistogramData& to = shared->histograms[h];
+        to.count.store(from.count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        to.sum.store(from.sum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        to.max.store(from.max.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        for (size_t b = 0; b < TELEMETRY_HISTOGRAM_BUCKETS; ++b) {
+            to.buckets[b].store(from.buckets[b].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    initialize(*shared);
+
+    mapping = view;
+    data = shared;
+    segmentName = name;
+    return true;
+}
+
+void Telemetry::close() {
+    if (!mapping) {
+        return;
+    }
+    data = &privateBlock;
+
+#ifdef _WIN32
+    UnmapViewOfFile(mapping);
+    CloseHandle(static_cast<HANDLE>(mappingHandle));
+    mappingHandle = nullptr;
+#else
+    munmap(mapping, sizeof(TelemetryBlock));
+    // Only unlink the name while it still refers to our segment
+    const std::string path = segmentPath(segmentName);
+    int fd = shm_open(path.c_str(), O_RDONLY, 0);
+    if (fd >= 0) {
+        struct stat status;
+        if (fstat(fd, &status) == 0 && static_cast<uint64_t>(status.st_dev) == segmentDevice && static_cast<uint64_t>(status.st_ino) == segmentInode) {
+            shm_unlink(path.c_str());
+        }
+        ::close(fd);
+    }
+#endif
+    mapping = nullptr;
+    segmentName.clear();
+}
+
+const TelemetryBlock* Telemetry::attach(const std::string& name) {
+    const std::string path = segmentPath(name);
+    void* view = nullptr;
+
+#ifdef _WIN32
+    HANDLE handle = OpenFileMappingA(FILE_MAP_READ, FALSE, path.c_str());
+    if (!handle) {
+        return nullptr;
+    }
+    view = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, sizeof(TelemetryBlock));
+    CloseHandle(handle); // The view keeps the mapping alive
+    if (!view) {
+        return nullptr;
+    }
+#else
+    int fd = shm_open(path.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(TelemetryBlock)) {
+        ::close(fd);
+        return nullptr;
+    }
+    view = mmap(nullptr, sizeof(TelemetryBlock), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        return nullptr;
+    }
+#endif
+
+    const TelemetryBlock* block = static_cast<const TelemetryBlock*>(view);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (block->magic != TELEMETRY_MAGIC || block->version != TELEMETRY_VERSION || block->size < sizeof(TelemetryBlock)) {
+        detach(block);
+        return nullptr;
+    }
+    return block;
+}
+
+void Telemetry::detach(const TelemetryBlock* block) {
+    if (!block) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(block);
+#else
+    munmap(const_cast<TelemetryBlock*>(block), sizeof(TelemetryBlock));
+#endif
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+// Live counters and histograms, published in a named shared memory segment
+// (POSIX shm_open, a named file mapping on Windows) so external tools can
+// watch a running instance. The block layout is the wire format: fields are
+// only ever appended, indices never reused, and readers check the version.
+// Updates are single relaxed atomic operations, wait-free and cheap enough
+// to leave on.
+
+constexpr uint32_t TELEMETRY_MAGIC = 0x4D4C5444;  // "DTLM"
+constexpr uint32_t TELEMETRY_VERSION = 1;
+constexpr size_t TELEMETRY_MAX_COUNTERS = 32;
+constexpr size_t TELEMETRY_MAX_HISTOGRAMS = 8;
+constexpr size_t TELEMETRY_HISTOGRAM_BUCKETS = 32;
+
+// Counter slots. Append only: the index is part of the layout.
+enum class TelemetryCounter : uint32_t {
+    Ticks,              // Simulation ticks run
+    Frames,             // Frames painted
+    Enemies,            // Gauge: live enemies
+    Bullets,            // Gauge: live bullets
+    Explosions,         // Gauge: live explosions
+    Collisions,         // Hits since start
+    TickCollisions,     // Gauge: hits in the last tick
+    Score,              // Gauge
+    DroppedInputs,      // Gauge: input events lost to a full queue
+    SnapshotsMissed,    // Gauge: snapshots replaced before the renderer saw them
+    EntityUpdates,      // Live entities summed over all ticks
+    SleepingEntities,   // Gauge: enemies asleep in inactive chunks (large world)
+    OccupiedChunks,     // Gauge: chunks holding sleepers
+    ChunkMigrations,    // Gauge: enemies put to sleep or woken since the last reset
+    Count
+};
+
+// Histogram slots, values in microseconds. Append only.
+enum class TelemetryHistogram : uint32_t {
+    FrameTime,          // paintGL duration
+    TickTime,           // Simulation step duration
+    BackgroundGpuTime,  // GPU time of the background pass (timer queries)
+    Count
+};
+
+static_assert(static_cast<size_t>(TelemetryCounter::Count) <= TELEMETRY_MAX_COUNTERS);
+static_assert(static_cast<size_t>(TelemetryHistogram::Count) <= TELEMETRY_MAX_HISTOGRAMS);
+
+const char* telemetryCounterName(TelemetryCounter counter);
+const char* telemetryHistogramName(TelemetryHistogram histogram);
+
+// Power of two buckets: bucket b counts values v with bit width b
+// (0, 1, 2-3, 4-7, ...), the last bucket takes everything above.
+struct TelemetryHistogramData {
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> max;      // Written by the histogram's single writer thread
+    std::atomic<uint64_t> buckets[TELEMETRY_HISTOGRAM_BUCKETS];
+};
+
+struct TelemetryBlock {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;                  // sizeof(TelemetryBlock) of the writer
+    uint32_t processId;
+    uint64_t startTimeMs;           // Unix time the segment was created
+    std::atomic<uint64_t> counters[TELEMETRY_MAX_COUNTERS];
+    TelemetryHistogramData histograms[TELEMETRY_MAX_HISTOGRAMS];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared memory counters need lock-free atomics");
+static_assert(std::is_standard_layout_v<TelemetryBlock>);
+static_assert(sizeof(TelemetryBlock) == 24 + 8 * TELEMETRY_MAX_COUNTERS + 8 * (3 + TELEMETRY_HISTOGRAM_BUCKETS) * TELEMETRY_MAX_HISTOGRAMS, "Telemetry layout changed");
+
+// Writer side. Starts out on a private block, so recording always works;
+// open() moves it to a shared segment other processes can attach to.
+class Telemetry {
+public:
+    Telemetry();
+    Telemetry(const Telemetry&) = delete;
+    Telemetry& operator=(const Telemetry&) = delete;
+    ~Telemetry();
+
+    // Creates the named segment and carries over what was recorded so far.
+    // A segment left behind by a process that is gone is replaced, one owned
+    // by a live process makes this fail. Call before other threads start
+    // recording. Returns false and keeps the private block on failure.
+    bool open(const std::string& name);
+    void close();
+    bool isShared() const { return mapping != nullptr; }
+    const std::string& name() const { return segmentName; }
+
+    void add(TelemetryCounter counter, uint64_t amount = 1) {
+        data->counters[static_cast<size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    void set(TelemetryCounter counter, uint64_t value) {
+        data->counters[static_cast<size_t>(counter)].store(value, std::memory_order_relaxed);
+    }
+
+    // Only one thread may record into a given histogram
+    void record(TelemetryHistogram histogram, uint64_t value) {
+        TelemetryHistogramData& target = data->histograms[static_cast<size_t>(histogram)];
+        size_t bucket = std::min<size_t>(std::bit_width(value), TELEMETRY_HISTOGRAM_BUCKETS - 1);
+        target.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        target.sum.fetch_add(value, std::memory_order_relaxed);
+        if (value > target.max.load(std::memory_order_relaxed)) {
+            target.max.store(value, std::memory_order_relaxed);
+        }
+        target.count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const TelemetryBlock& block() const { return *data; }
+
+    // Default segment name for this process
+    static std::string defaultName();
+
+    // Reader side: maps an existing segment read-only, nullptr if it doesn't
+    // exist or isn't a compatible telemetry block. Release with detach().
+    static const TelemetryBlock* attach(const std::string& name);
+    static void detach(const TelemetryBlock* block);
+
+private:
+    static void initialize(TelemetryBlock& block);
+
+    TelemetryBlock privateBlock;
+    TelemetryBlock* data = &privateBlock;
+    void* mapping = nullptr;        // Shared block, or nullptr while on privateBlock
+    void* mappingHandle = nullptr;  // Windows file mapping handle
+    uint64_t segmentDevice = 0;     // POSIX identity of the segment we created, so
+    uint64_t segmentInode = 0;      // close() doesn't unlink a newer one of the same name
+    std::string segmentName;
+};
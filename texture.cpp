@@ -0,0 +1,40 @@
+#include "texture.h"
+#include <QDebug>
+#include <algorithm>
+
+std::unique_ptr<QOpenGLTexture> createMipmappedTexture(const QImage& image, QOpenGLTexture::WrapMode wrapMode) {
+    auto texture = std::make_unique<QOpenGLTexture>(image, QOpenGLTexture::GenerateMipMaps);
+    texture->setMinificationFilter(QOpenGLTexture::LinearMipMapLinear);
+    texture->setMagnificationFilter(QOpenGLTexture::Linear);
+    texture->setWrapMode(wrapMode);
+    return texture;
+}
+
+QImage selectLevelOfDetail(const QImage& source, int targetWidth, int targetHeight) {
+    QSize size = source.size();
+    while (size.width() / 2 >= targetWidth && size.height() / 2 >= targetHeight) {
+        size /= 2;
+    }
+
+    if (size == source.size()) {
+        return source;
+    }
+    return source.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+}
+
+qint64 textureMemoryBytes(const QOpenGLTexture& texture) {
+    const qint64 bytesPerTexel = 4;
+    qint64 total = 0;
+    for (int level = 0; level < std::max(1, texture.mipLevels()); ++level) {
+        qint64 width = std::max(1, texture.width() >> level);
+        qint64 height = std::max(1, texture.height() >> level);
+        total += width * height * bytesPerTexel;
+    }
+    return total;
+}
+
+void reportTextureMemory(const char* name, const QOpenGLTexture& texture) {
+    qInfo() << "Texture" << name << texture.width() << "x" << texture.height()
+            << "levels:" << texture.mipLevels()
+            << "GPU memory:" << textureMemoryBytes(texture) / 1024 << "KiB";
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <QOpenGLTexture>
+#include <QImage>
+#include <memory>
+
+// Uploads an image with a full mipmap chain and trilinear minification
+std::unique_ptr<QOpenGLTexture> createMipmappedTexture(const QImage& image, QOpenGLTexture::WrapMode wrapMode = QOpenGLTexture::Repeat);
+
+// Halves the image until one more halving would drop below the target size
+QImage selectLevelOfDetail(const QImage& source, int targetWidth, int targetHeight);
+
+// GPU memory used by the texture, all mip levels included (RGBA8 assumed)
+qint64 textureMemoryBytes(const QOpenGLTexture& texture);
+
+void reportTextureMemory(const char* name, const QOpenGLTexture& texture);
@@ -0,0 +1,208 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Handle to a scheduled timer, used to cancel it. Stale handles (timer fired
+// or cancelled, node reused) are recognized by the generation and ignored.
+struct TimerId {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool valid() const { return index != UINT32_MAX; }
+};
+
+// Hierarchical timing wheel counting in simulation ticks. Four levels of 256
+// slots cover about 2^32 ticks: level 0 holds timers due within the current 256
+// tick span, each higher level 256 times coarser. When a lower level wraps,
+// the next slot of the level above is cascaded down, so every timer moves at
+// most three times before it fires. schedule() and cancel() are O(1) and
+// advance() only touches the slot that is due.
+// Timers are nodes of intrusive lists, pooled in one vector and recycled
+// through a free list, so once warmed up the wheel doesn't allocate.
+template <typename Payload>
+class TimerWheel {
+public:
+    static constexpr uint32_t SLOT_BITS = 8;
+    static constexpr uint32_t SLOTS = 1u << SLOT_BITS;
+    static constexpr uint32_t LEVELS = 4;
+    // Keeps a top level timer out of the slot that is current, about two years at 60 Hz
+    static constexpr uint64_t MAX_DELAY = uint64_t(SLOTS - 2) << (SLOT_BITS * (LEVELS - 1));
+
+    TimerWheel() {
+        for (auto& slot : slots) {
+            slot = { NONE, NONE };
+        }
+    }
+
+    // Fires payload in the advance() 'ticks' calls after the next one (0 = next advance())
+    TimerId schedule(uint64_t ticks, const Payload& payload) {
+        assert(ticks <= MAX_DELAY);
+        uint32_t index = allocateNode();
+        Node& node = nodes[index];
+        node.payload = payload;
+        node.dueTick = currentTick + ticks;
+        link(index);
+        ++pendingCount;
+        return { index, node.generation };
+    }
+
+    // Returns whether the timer was still pending
+    bool cancel(TimerId id) {
+        if (!isPending(id)) {
+            return false;
+        }
+        unlink(id.index);
+        freeNode(id.index);
+        --pendingCount;
+        return true;
+    }
+
+    bool isPending(TimerId id) const {
+        return id.index < nodes.size() && nodes[id.index].generation == id.generation && nodes[id.index].slot != NONE;
+    }
+
+    // Processes the current tick: appends the payloads of every timer due now
+    // to 'due' and moves the clock on by one tick
+    void advance(std::vector<Payload>& due) {
+        // Cascade from the highest level that wrapped down to level 1
+        if ((currentTick & (SLOTS - 1)) == 0 && currentTick != 0) {
+            uint32_t level = 1;
+            while (level + 1 < LEVELS && ((currentTick >> (SLOT_BITS * level)) & (SLOTS - 1)) == 0) {
+                ++level;
+            }
+            for (; level >= 1; --level) {
+                cascade(level);
+            }
+        }
+
+        uint32_t slot = static_cast<uint32_t>(currentTick & (SLOTS - 1));
+        uint32_t index = slots[slot].head;
+        slots[slot] = { NONE, NONE };
+        while (index != NONE) {
+            uint32_t next = nodes[index].next;
+            due.push_back(nodes[index].payload);
+            freeNode(index);
+            --pendingCount;
+            index = next;
+        }
+        ++currentTick;
+    }
+
+    // Visits the payload of every pending timer, in no particular order
+    template <typename Fn>
+    void forEachPending(Fn&& fn) const {
+        for (const auto& slot : slots) {
+            for (uint32_t index = slot.head; index != NONE; index = nodes[index].next) {
+                fn(nodes[index].payload);
+            }
+        }
+    }
+
+    void clear() {
+        for (auto& slot : slots) {
+            slot = { NONE, NONE };
+        }
+        nodes.clear();
+        freeHead = NONE;
+        pendingCount = 0;
+    }
+
+    uint64_t now() const { return currentTick; }
+    size_t pending() const { return pendingCount; }
+    size_t capacity() const { return nodes.size(); }
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Node {
+        Payload payload{};
+        uint64_t dueTick = 0;
+        uint32_t prev = NONE, next = NONE;  // Slot list, or free list through next
+        uint32_t slot = NONE;               // Slot holding the node, NONE while free
+        uint32_t generation = 0;
+    };
+
+    struct Slot {
+        uint32_t head, tail;
+    };
+
+    uint32_t allocateNode() {
+        if (freeHead == NONE) {
+            nodes.emplace_back();
+            return static_cast<uint32_t>(nodes.size() - 1);
+        }
+        uint32_t index = freeHead;
+        freeHead = nodes[index].next;
+        return index;
+    }
+
+    void freeNode(uint32_t index) {
+        Node& node = nodes[index];
+        node.payload = Payload{};
+        node.slot = NONE;
+        ++node.generation;
+        node.next = freeHead;
+        freeHead = index;
+    }
+
+    // Level = highest 8 bit digit in which the due tick differs from now, so a
+    // timer sits in the level whose slot comes round before it is due
+    void link(uint32_t index) {
+        Node& node = nodes[index];
+        uint64_t differing = node.dueTick ^ currentTick;
+        uint32_t level = 0;
+        while (level + 1 < LEVELS && (differing >> (SLOT_BITS * (level + 1))) != 0) {
+            ++level;
+        }
+        node.slot = level * SLOTS + static_cast<uint32_t>((node.dueTick >> (SLOT_BITS * level)) & (SLOTS - 1));
+
+        // Append, so timers due on the same tick fire in scheduling order
+        Slot& slot = slots[node.slot];
+        node.prev = slot.tail;
+        node.next = NONE;
+        if (slot.tail != NONE) {
+            nodes[slot.tail].next = index;
+        }
+        else {
+            slot.head = index;
+        }
+        slot.tail = index;
+    }
+
+    void unlink(uint32_t index) {
+        Node& node = nodes[index];
+        Slot& slot = slots[node.slot];
+        if (node.prev != NONE) {
+            nodes[node.prev].next = node.next;
+        }
+        else {
+            slot.head = node.next;
+        }
+        if (node.next != NONE) {
+            nodes[node.next].prev = node.prev;
+        }
+        else {
+            slot.tail = node.prev;
+        }
+    }
+
+    // Re-links the timers of the level's current slot, they now fit a lower level
+    void cascade(uint32_t level) {
+        Slot& slot = slots[level * SLOTS + ((currentTick >> (SLOT_BITS * level)) & (SLOTS - 1))];
+        uint32_t index = slot.head;
+        slot = { NONE, NONE };
+        while (index != NONE) {
+            uint32_t next = nodes[index].next;
+            link(index);
+            index = next;
+        }
+    }
+
+    Slot slots[LEVELS * SLOTS];
+    std::vector<Node> nodes;
+    uint32_t freeHead = NONE;
+    uint64_t currentTick = 0;
+    size_t pendingCount = 0;
+};
@@ -0,0 +1,474 @@
+// Plays many independent headless games across all cores, each one as fast
+// as the simulation runs, and streams one result line per game.
+//
+//   batch_runner <games file> [--out <file>] [--threads <n>] [--waves <wave table>]
+//
+// The games file lists policies, seeds and limits, see batch_games.txt.
+// Results go to --out (default stdout), progress and games per second to stderr.
+// --waves defaults to the game's waves.txt, one directory above the executable.
+//
+//   g++ -std=c++20 -O2 -I.. batch_runner.cpp ../simulation.cpp ../ecs.cpp ../systems.cpp ../enemy.cpp ../chunks.cpp ../behaviour.cpp ../framepool.cpp ../scripts.cpp ../telemetry.cpp ../spatialgrid.cpp -pthread -o batch_runner
+
+#include "simulation.h"
+#include <algorithm>
+#include <charconv>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+enum class Policy { Idle, Random, Sweep, Hunter, Script };
+
+struct ScriptAction {
+    uint64_t tick;
+    InputAction action;
+};
+
+struct BatchEntry {
+    std::string name;               // Policy as written in the games file
+    Policy policy = Policy::Idle;
+    uint32_t firstSeed = 1, lastSeed = 1;
+    uint64_t ticks = 3600;
+    int waves = 1;
+    int fireInterval = 8;
+    bool large = false;
+    std::vector<ScriptAction> actions;  // Sorted by tick
+};
+
+struct GameResult {
+    uint32_t seed = 0;
+    int score = 0;
+    uint64_t ticks = 0;
+    uint64_t kills = 0;
+    size_t enemiesLeft = 0;
+    bool cleared = false;           // Every enemy killed before the tick limit
+};
+
+static bool parseAction(const std::string& name, InputAction& action) {
+    static const struct { const char* name; InputAction action; } actions[] = {
+        { "up", InputAction::MoveUp }, { "down", InputAction::MoveDown },
+        { "left", InputAction::MoveLeft }, { "right", InputAction::MoveRight },
+        { "stoph", InputAction::StopHorizontal }, { "stopv", InputAction::StopVertical },
+        { "fire", InputAction::Fire }, { "enemy", InputAction::SpawnEnemy },
+        { "wave", InputAction::SpawnNextWave }, { "raid", InputAction::StartRaid },
+    };
+    for (const auto& entry : actions) {
+        if (name == entry.name) {
+            action = entry.action;
+            return true;
+        }
+    }
+    return false;
+}
+
+// The whole text as a number, false on empty, partial or out of range input
+template <typename T>
+static bool parseNumber(std::string_view text, T& value) {
+    auto [end, status] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return status == std::errc() && end == text.data() + text.size();
+}
+
+static bool parseEntry(const std::string& line, BatchEntry& entry, std::string& error) {
+    std::istringstream fields(line);
+    fields >> entry.name;
+    static const struct { const char* name; Policy policy; } policies[] = {
+        { "idle", Policy::Idle }, { "random", Policy::Random }, { "sweep", Policy::Sweep },
+        { "hunter", Policy::Hunter }, { "script", Policy::Script },
+    };
+    auto policy = std::find_if(std::begin(policies), std::end(policies), [&](const auto& p) { return entry.name == p.name; });
+    if (policy == std::end(policies)) {
+        error = "unknown policy '" + entry.name + "'";
+        return false;
+    }
+    entry.policy = policy->policy;
+
+    std::string field;
+    while (fields >> field) {
+        size_t equals = field.find('=');
+        std::string key = field.substr(0, equals);
+        std::string value = equals == std::string::npos ? std::string() : field.substr(equals + 1);
+
+        if (key == "large") {
+            entry.large = true;
+        }
+        else if (key == "seeds") {
+            size_t dash = value.find('-');
+            std::string_view first = std::string_view(value).substr(0, dash);
+            bool ok = parseNumber(first, entry.firstSeed);
+            entry.lastSeed = entry.firstSeed;
+            if (dash != std::string::npos) {
+                ok = ok && parseNumber(std::string_view(value).substr(dash + 1), entry.lastSeed);
+            }
+            if (!ok) {
+                error = "bad value for 'seeds'";
+                return false;
+            }
+        }
+        else if (key == "ticks" || key == "waves" || key == "fire") {
+            bool ok = false;
+            if (key == "ticks") {
+                ok = parseNumber(value, entry.ticks);
+            }
+            else if (key == "waves") {
+                ok = parseNumber(value, entry.waves);
+            }
+            else {
+                ok = parseNumber(value, entry.fireInterval);
+                entry.fireInterval = std::max(1, entry.fireInterval);
+            }
+            if (!ok) {
+                error = "bad value for '" + key + "'";
+                return false;
+            }
+        }
+        else if (key == "actions") {
+            std::istringstream list(value);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                size_t colon = item.find(':');
+                ScriptAction action{};
+                if (colon == std::string::npos || !parseNumber(std::string_view(item).substr(0, colon), action.tick) ||
+                    !parseAction(item.substr(colon + 1), action.action)) {
+                    error = "bad action '" + item + "'";
+                    return false;
+                }
+                entry.actions.push_back(action);
+            }
+            std::stable_sort(entry.actions.begin(), entry.actions.end(), [](const ScriptAction& a, const ScriptAction& b) { return a.tick < b.tick; });
+        }
+        else {
+            error = "unknown setting '" + key + "'";
+            return false;
+        }
+    }
+
+    // Start waves go through the input queue in one tick
+    if (entry.lastSeed < entry.firstSeed || entry.ticks == 0 || entry.waves < 0 || entry.waves > GameSettings::INPUT_QUEUE_SIZE / 2) {
+        error = "bad seeds, ticks or waves";
+        return false;
+    }
+    return true;
+}
+
+// One game's input, decided before every tick from what the policy sees
+class Player {
+public:
+    Player(const BatchEntry& entry, uint32_t seed) : entry(entry) { random.setSeed(seed * 0x85EBCA6Bu + 7); }
+
+    void act(Simulation& simulation);
+
+private:
+    void moveVertical(Simulation& simulation, int direction);
+    void moveHorizontal(Simulation& simulation, int direction);
+    void fire(Simulation& simulation);
+    void hunt(Simulation& simulation);
+
+    const BatchEntry& entry;
+    Random random;
+    size_t nextAction = 0;
+    int vertical = 0;               // Movement currently requested, -1, 0 or 1
+    int horizontal = 0;
+    bool facingRight = true;
+    uint64_t lastShot = 0;
+    bool hasShot = false;
+};
+
+void Player::moveVertical(Simulation& simulation, int direction) {
+    if (direction != vertical) {
+        vertical = direction;
+        simulation.postInput({ direction > 0 ? InputAction::MoveUp : direction < 0 ? InputAction::MoveDown : InputAction::StopVertical });
+    }
+}
+
+void Player::moveHorizontal(Simulation& simulation, int direction) {
+    if (direction != horizontal) {
+        horizontal = direction;
+        simulation.postInput({ direction > 0 ? InputAction::MoveRight : direction < 0 ? InputAction::MoveLeft : InputAction::StopHorizontal });
+        if (direction != 0) {
+            facingRight = direction > 0;
+        }
+    }
+}
+
+void Player::fire(Simulation& simulation) {
+    const uint64_t tick = simulation.getTick();
+    if (hasShot && tick - lastShot < static_cast<uint64_t>(entry.fireInterval)) {
+        return;
+    }
+    simulation.postInput({ InputAction::Fire });
+    lastShot = tick;
+    hasShot = true;
+}
+
+// Lines up with the nearest live enemy, facing it from a little distance
+void Player::hunt(Simulation& simulation) {
+    static constexpr float ALIGNED = 0.05f;
+    static constexpr float DISTANCE = 0.5f;
+
+    const float x = static_cast<float>(simulation.getSpaceshipX());
+    const float y = static_cast<float>(simulation.getSpaceshipY());
+    float bestDistance = 0.0f, targetX = 0.0f, targetY = 0.0f;
+    bool found = false;
+    simulation.getWorld().forEachTable(Component::Position | Component::Target, [&](const ArchetypeTable& table) {
+        for (size_t i = 0; i < table.size(); ++i) {
+            float dx = static_cast<float>(table.positionX[i]) - x;
+            float dy = static_cast<float>(table.positionY[i]) - y;
+            float distance = dx * dx + dy * dy;
+            if (!found || distance < bestDistance) {
+                found = true;
+                bestDistance = distance;
+                targetX = dx;
+                targetY = dy;
+            }
+        }
+    });
+    if (!found) {
+        moveVertical(simulation, 0);
+        moveHorizontal(simulation, 0);
+        return;
+    }
+
+    moveVertical(simulation, targetY > ALIGNED ? 1 : targetY < -ALIGNED ? -1 : 0);
+    const bool wantRight = targetX > 0.0f;
+    moveHorizontal(simulation, std::abs(targetX) > DISTANCE || facingRight != wantRight ? (wantRight ? 1 : -1) : 0);
+    if (std::abs(targetY) <= ALIGNED && facingRight == wantRight) {
+        fire(simulation);
+    }
+}
+
+void Player::act(Simulation& simulation) {
+    const uint64_t tick = simulation.getTick();
+
+    switch (entry.policy) {
+    case Policy::Idle:
+        break;
+    case Policy::Random:
+        if (tick % 15 == 0) {
+            moveVertical(simulation, static_cast<int>(random.next() % 3) - 1);
+            moveHorizontal(simulation, static_cast<int>(random.next() % 3) - 1);
+        }
+        if (random.next() % static_cast<uint32_t>(entry.fireInterval) == 0) {
+            fire(simulation);
+        }
+        break;
+    case Policy::Sweep:
+        moveVertical(simulation, (tick / 60) % 2 == 0 ? 1 : -1);
+        fire(simulation);
+        break;
+    case Policy::Hunter:
+        hunt(simulation);
+        break;
+    case Policy::Script:
+        for (; nextAction < entry.actions.size() && entry.actions[nextAction].tick <= tick; ++nextAction) {
+            simulation.postInput({ entry.actions[nextAction].action });
+        }
+        break;
+    }
+}
+
+static size_t enemiesLeft(const Simulation& simulation) {
+    const World& world = simulation.getWorld();
+    return world.count(ArchetypeId::Enemy) + world.count(ArchetypeId::ScriptedEnemy) + simulation.chunks().sleeping();
+}
+
+static GameResult playGame(const BatchEntry& entry, uint32_t seed, const std::string& waves) {
+    Simulation simulation;
+    simulation.setPublishSnapshots(false);
+    simulation.setSeed(seed);
+    simulation.setLargeWorld(entry.large);
+    std::string error;
+    simulation.loadWaves(waves, error);   // Checked once in main
+
+    for (int i = 0; i < entry.waves; ++i) {
+        simulation.postInput({ InputAction::SpawnNextWave });
+    }
+
+    Player player(entry, seed);
+    GameResult result;
+    result.seed = seed;
+    while (simulation.getTick() < entry.ticks) {
+        player.act(simulation);
+        simulation.step();
+
+        // Over once everything spawned so far is dead and no script will spawn more
+        if (simulation.getKills() > 0 && enemiesLeft(simulation) == 0 && !simulation.hasActiveBehaviours()) {
+            result.cleared = true;
+            break;
+        }
+    }
+
+    result.score = simulation.getScore();
+    result.ticks = simulation.getTick();
+    result.kills = simulation.getKills();
+    result.enemiesLeft = enemiesLeft(simulation);
+    return result;
+}
+
+// Per entry totals for the summary
+struct EntrySummary {
+    uint64_t games = 0;
+    uint64_t cleared = 0;
+    double score = 0.0;
+    double ticks = 0.0;
+    double kills = 0.0;
+};
+
+static int usage(const char* program) {
+    std::fprintf(stderr, "usage: %s <games file> [--out <file>] [--threads <n>] [--waves <wave table>]\n", program);
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        return usage(argv[0]);
+    }
+
+    std::string outPath, wavesPath = (std::filesystem::path(argv[0]).parent_path() / ".." / "waves.txt").string();
+    unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 2; i < argc; i += 2) {
+        if (i + 1 == argc) {
+            std::fprintf(stderr, "Option %s needs a value\n", argv[i]);
+            return usage(argv[0]);
+        }
+        if (std::strcmp(argv[i], "--out") == 0) {
+            outPath = argv[i + 1];
+        }
+        else if (std::strcmp(argv[i], "--threads") == 0) {
+            if (!parseNumber(argv[i + 1], threadCount) || threadCount == 0) {
+                std::fprintf(stderr, "Bad value for --threads: %s\n", argv[i + 1]);
+                return usage(argv[0]);
+            }
+        }
+        else if (std::strcmp(argv[i], "--waves") == 0) {
+            wavesPath = argv[i + 1];
+        }
+        else {
+            std::fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    std::ifstream wavesFile(wavesPath);
+    if (!wavesFile) {
+        std::fprintf(stderr, "Cannot read wave table %s\n", wavesPath.c_str());
+        return 2;
+    }
+    std::stringstream waves;
+    waves << wavesFile.rdbuf();
+    std::string wavesError;
+    if (!Simulation().loadWaves(waves.str(), wavesError)) {
+        std::fprintf(stderr, "%s: %s\n", wavesPath.c_str(), wavesError.c_str());
+        return 2;
+    }
+
+    std::ifstream gamesFile(argv[1]);
+    if (!gamesFile) {
+        std::fprintf(stderr, "Cannot read %s\n", argv[1]);
+        return 2;
+    }
+    std::vector<BatchEntry> entries;
+    std::string line;
+    for (int lineNumber = 1; std::getline(gamesFile, line); ++lineNumber) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+        BatchEntry entry;
+        std::string error;
+        if (!parseEntry(line, entry, error)) {
+            std::fprintf(stderr, "%s:%d: %s\n", argv[1], lineNumber, error.c_str());
+            return 2;
+        }
+        entries.push_back(std::move(entry));
+    }
+
+    // One job per game
+    struct Job {
+        uint32_t entry;
+        uint32_t seed;
+    };
+    std::vector<Job> jobs;
+    for (uint32_t e = 0; e < entries.size(); ++e) {
+        for (uint64_t seed = entries[e].firstSeed; seed <= entries[e].lastSeed; ++seed) {
+            jobs.push_back({ e, static_cast<uint32_t>(seed) });
+        }
+    }
+
+    FILE* out = outPath.empty() ? stdout : std::fopen(outPath.c_str(), "w");
+    if (!out) {
+        std::fprintf(stderr, "Cannot write %s\n", outPath.c_str());
+        return 2;
+    }
+    std::fprintf(out, "# entry policy seed score ticks kills enemies_left cleared\n");
+
+    std::mutex outMutex;
+    std::vector<EntrySummary> summaries(entries.size());
+    std::atomic<size_t> nextJob{ 0 };
+    std::atomic<size_t> finished{ 0 };
+    std::atomic<uint64_t> ticksRun{ 0 };
+    const std::string waveTable = waves.str();
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threadCount; ++t) {
+        workers.emplace_back([&] {
+            for (size_t j = nextJob.fetch_add(1); j < jobs.size(); j = nextJob.fetch_add(1)) {
+                const BatchEntry& entry = entries[jobs[j].entry];
+                GameResult result = playGame(entry, jobs[j].seed, waveTable);
+                {
+                    std::lock_guard<std::mutex> lock(outMutex);
+                    std::fprintf(out, "%u %s %u %d %llu %llu %zu %d\n", jobs[j].entry, entry.name.c_str(), result.seed, result.score,
+                        static_cast<unsigned long long>(result.ticks), static_cast<unsigned long long>(result.kills), result.enemiesLeft, result.cleared ? 1 : 0);
+                    EntrySummary& summary = summaries[jobs[j].entry];
+                    ++summary.games;
+                    summary.cleared += result.cleared ? 1 : 0;
+                    summary.score += result.score;
+                    summary.ticks += static_cast<double>(result.ticks);
+                    summary.kills += static_cast<double>(result.kills);
+                }
+                ticksRun.fetch_add(result.ticks, std::memory_order_relaxed);
+                finished.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    // Progress once a second while the workers run
+    auto elapsedSeconds = [&] { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); };
+    double lastReport = 0.0;
+    while (finished.load(std::memory_order_relaxed) < jobs.size()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        double seconds = elapsedSeconds();
+        if (seconds - lastReport >= 1.0) {
+            lastReport = seconds;
+            size_t done = finished.load(std::memory_order_relaxed);
+            std::fprintf(stderr, "%zu/%zu games, %.1f games/s\n", done, jobs.size(), done / seconds);
+        }
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    const double seconds = elapsedSeconds();
+    if (out != stdout) {
+        std::fclose(out);
+    }
+
+    std::fprintf(stderr, "\n%zu games on %u threads in %.2f s: %.1f games/s, %.2f M ticks/s\n", jobs.size(), threadCount, seconds,
+        jobs.size() / seconds, ticksRun.load() / seconds / 1.0e6);
+    std::fprintf(stderr, "%5s %-8s %7s %10s %10s %8s %8s\n", "entry", "policy", "games", "mean score", "mean ticks", "kills", "cleared");
+    for (size_t e = 0; e < entries.size(); ++e) {
+        const EntrySummary& summary = summaries[e];
+        const double games = static_cast<double>(std::max<uint64_t>(1, summary.games));
+        std::fprintf(stderr, "%5zu %-8s %7llu %10.1f %10.1f %8.1f %7.1f%%\n", e, entries[e].name.c_str(), static_cast<unsigned long long>(summary.games),
+            summary.score / games, summary.ticks / games, summary.kills / games, 100.0 * summary.cleared / games);
+    }
+    return 0;
+}
@@ -0,0 +1,152 @@
+// Prints the live telemetry of a running game instance.
+//
+//   telemetry_reader <name | pid>              print all counters and histograms once
+//   telemetry_reader <name | pid> --watch [ms] one line per interval with rates and
+//                                              percentiles over that interval
+//
+//   g++ -std=c++20 -O2 -I.. telemetry_reader.cpp ../telemetry.cpp -o telemetry_reader
+
+#include "telemetry.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+struct Sample {
+    uint64_t counters[TELEMETRY_MAX_COUNTERS];
+    uint64_t buckets[TELEMETRY_MAX_HISTOGRAMS][TELEMETRY_HISTOGRAM_BUCKETS];
+    uint64_t count[TELEMETRY_MAX_HISTOGRAMS];
+    uint64_t sum[TELEMETRY_MAX_HISTOGRAMS];
+};
+
+static void takeSample(const TelemetryBlock& block, Sample& sample) {
+    for (size_t i = 0; i < TELEMETRY_MAX_COUNTERS; ++i) {
+        sample.counters[i] = block.counters[i].load(std::memory_order_relaxed);
+    }
+    for (size_t h = 0; h < TELEMETRY_MAX_HISTOGRAMS; ++h) {
+        sample.count[h] = block.histograms[h].count.load(std::memory_order_relaxed);
+        sample.sum[h] = block.histograms[h].sum.load(std::memory_order_relaxed);
+        for (size_t b = 0; b < TELEMETRY_HISTOGRAM_BUCKETS; ++b) {
+            sample.buckets[h][b] = block.histograms[h].buckets[b].load(std::memory_order_relaxed);
+        }
+    }
+}
+
+// Upper bound of the bucket holding the given fraction of the values
+static uint64_t percentile(const uint64_t* buckets, double fraction) {
+    uint64_t total = 0;
+    for (size_t b = 0; b < TELEMETRY_HISTOGRAM_BUCKETS; ++b) {
+        total += buckets[b];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(fraction * (total - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t b = 0; b < TELEMETRY_HISTOGRAM_BUCKETS; ++b) {
+        seen += buckets[b];
+        if (seen >= rank) {
+            return b == 0 ? 0 : (uint64_t(1) << b) - 1;
+        }
+    }
+    return UINT64_MAX;
+}
+
+static void printOnce(const TelemetryBlock& block) {
+    Sample sample;
+    takeSample(block, sample);
+    std::printf("pid %u, telemetry version %u\n", block.processId, block.version);
+    for (size_t i = 0; i < static_cast<size_t>(TelemetryCounter::Count); ++i) {
+        std::printf("  %-18s %llu\n", telemetryCounterName(static_cast<TelemetryCounter>(i)), static_cast<unsigned long long>(sample.counters[i]));
+    }
+    for (size_t h = 0; h < static_cast<size_t>(TelemetryHistogram::Count); ++h) {
+        const uint64_t count = sample.count[h];
+        std::printf("  %-18s count %llu  mean %.1f  p50 <=%llu  p99 <=%llu  max %llu\n",
+            telemetryHistogramName(static_cast<TelemetryHistogram>(h)),
+            static_cast<unsigned long long>(count),
+            count ? static_cast<double>(sample.sum[h]) / count : 0.0,
+            static_cast<unsigned long long>(percentile(sample.buckets[h], 0.50)),
+            static_cast<unsigned long long>(percentile(sample.buckets[h], 0.99)),
+            static_cast<unsigned long long>(block.histograms[h].max.load(std::memory_order_relaxed)));
+    }
+}
+
+static void watch(const TelemetryBlock& block, int intervalMs) {
+    using Counter = TelemetryCounter;
+    const size_t frameTime = static_cast<size_t>(TelemetryHistogram::FrameTime);
+    const size_t tickTime = static_cast<size_t>(TelemetryHistogram::TickTime);
+
+    std::printf("%8s %8s %8s %8s %8s %8s %8s %9s %9s %9s %9s\n",
+        "ticks/s", "frames/s", "score/s", "hits/s", "enemies", "bullets", "explos",
+        "frame p50", "frame p99", "tick p50", "tick p99");
+
+    Sample previous, current;
+    takeSample(block, previous);
+    auto previousTime = std::chrono::steady_clock::now();
+    for (;;) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+        takeSample(block, current);
+        auto now = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(now - previousTime).count();
+
+        auto rate = [&](Counter counter) {
+            size_t i = static_cast<size_t>(counter);
+            return static_cast<double>(current.counters[i] - previous.counters[i]) / seconds;
+        };
+        auto gauge = [&](Counter counter) {
+            return static_cast<unsigned long long>(current.counters[static_cast<size_t>(counter)]);
+        };
+
+        // Percentiles of this interval only
+        uint64_t frameBuckets[TELEMETRY_HISTOGRAM_BUCKETS], tickBuckets[TELEMETRY_HISTOGRAM_BUCKETS];
+        for (size_t b = 0; b < TELEMETRY_HISTOGRAM_BUCKETS; ++b) {
+            frameBuckets[b] = current.buckets[frameTime][b] - previous.buckets[frameTime][b];
+            tickBuckets[b] = current.buckets[tickTime][b] - previous.buckets[tickTime][b];
+        }
+
+        int64_t scoreDelta = static_cast<int64_t>(current.counters[static_cast<size_t>(Counter::Score)] - previous.counters[static_cast<size_t>(Counter::Score)]);
+        std::printf("%8.1f %8.1f %8.1f %8.1f %8llu %8llu %8llu %7lluus %7lluus %7lluus %7lluus\n",
+            rate(Counter::Ticks), rate(Counter::Frames), scoreDelta / seconds, rate(Counter::Collisions),
+            gauge(Counter::Enemies), gauge(Counter::Bullets), gauge(Counter::Explosions),
+            static_cast<unsigned long long>(percentile(frameBuckets, 0.50)),
+            static_cast<unsigned long long>(percentile(frameBuckets, 0.99)),
+            static_cast<unsigned long long>(percentile(tickBuckets, 0.50)),
+            static_cast<unsigned long long>(percentile(tickBuckets, 0.99)));
+        std::fflush(stdout);
+
+        previous = current;
+        previousTime = now;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <segment name | pid> [--watch [ms]]\n", argv[0]);
+        return 2;
+    }
+
+    // A bare number is taken as the pid of an instance using the default name
+    std::string name = argv[1];
+    if (name.find_first_not_of("0123456789") == std::string::npos) {
+        name = "defender-telemetry-" + name;
+    }
+
+    const TelemetryBlock* block = Telemetry::attach(name);
+    if (!block) {
+        std::fprintf(stderr, "No compatible telemetry segment '%s'\n", name.c_str());
+        return 1;
+    }
+
+    if (argc > 2 && std::strcmp(argv[2], "--watch") == 0) {
+        int intervalMs = argc > 3 ? std::atoi(argv[3]) : 1000;
+        watch(*block, intervalMs > 0 ? intervalMs : 1000);
+    }
+    else {
+        printOnce(*block);
+    }
+
+    Telemetry::detach(block);
+    return 0;
+}